@@ -38,6 +38,9 @@ pModel_(pModel), lpIteration_(0), last_node(-1), heuristicHasBeenRun_(false),nbN
    // Initialization of nb_dives_to_wait_before_branching_on_columns_
    for(int i=4; i<1000000; i*=2)
       nb_dives_to_wait_before_branching_on_columns_.push_back(i);
+
+   // the first LP solve starts now
+   timerLp_.start();
 }
 
 //Initialize the lp parameters and the OsiSolver
@@ -217,6 +220,11 @@ void BcpLpModel::modify_lp_parameters ( OsiSolverInterface* lp, const int change
 			lp->writeLp("outfiles/test");
 		}
 
+		// warm start the first LP of the root node with the basis of the previous solve
+		if (current_index() == 0 && !in_strong_branching) {
+			pModel_->loadLpBasis(lp);
+		}
+
 		// modify dual tolerance // DBG
 		// double dualTol = std::min(0.1,-pModel_->getParameters().sp_max_reduced_cost_bound_+EPSILON);
 		// lp->setDblParam( OsiDualTolerance,dualTol);
@@ -318,7 +326,7 @@ bool BcpLpModel::doStop(){
    pModel_->doStop();
 
    //fathom if the true lower bound greater than current upper bound
-   if(pModel_->getObjective() - getLpProblemPointer()->node->true_lower_bound <
+   if(pModel_->getPruningUB() - getLpProblemPointer()->node->true_lower_bound <
       pModel_->getParameters().absoluteGap_ - EPSILON)
       return true;
 
@@ -406,21 +414,14 @@ void BcpLpModel::TransformVarsToColumns(BCP_vec<BCP_var*>& vars, BCP_vec<BCP_col
       if(!var)
          Tools::throwError("Bad variable casting.");
 
-      //Copy the vectors var->getIndexRows() and var->getCoeffRows() in arrays
+      //the rows of the column are stored contiguously in the var:
+      //BCP_col copies them in a single pass without any intermediate array
+      const int* indexRows = var->getIndexRows().data();
+      const double* coeffRows = var->getCoeffRows().data();
       const int size = var->getNbRows();
 
-      //create a new array which will be deleted by ~BCP_col()
-      int* indexRows = new int[size];
-      vector<int>& index = var->getIndexRows();
-      copy(index.begin(), index.end(), indexRows);
-
-      //create a new array which will be deleted by ~BCP_col()
-      double* coeffRows = new double[size];
-      vector<double>& coeffs = var->getCoeffRows();
-      copy(coeffs.begin(), coeffs.end(), coeffRows);
-
       cols.unchecked_push_back(
-         new BCP_col(size, indexRows, coeffRows, var->getCost(), var->getLB(), var->getUB()) );
+         new BCP_col(indexRows, indexRows+size, coeffRows, coeffRows+size, var->getCost(), var->getLB(), var->getUB()) );
    }
 }
 
@@ -469,9 +470,34 @@ void BcpLpModel::generate_vars_in_lp(const BCP_lp_result& lpres,
 	// call the rotation pricer to find columns that should be added to the LP
 	//
 	pModel_->setLPSol(lpres, vars, lpIteration_);
+	if(pModel_->isMetrics()){
+		std::stringstream line;
+		line << "{\"event\":\"lp\",\"lp_it\":" << lpIteration_ << ",\"node\":" << current_index();
+		line << ",\"objective\":" << lpres.objval() << ",\"time\":" << timerLp_.dSinceStart();
+		line << ",\"columns\":" << vars.size() - pModel_->getCoreVars().size() << "}";
+		pModel_->writeMetrics(line.str());
+	}
+	Tools::Timer timerPricing; timerPricing.start();
 	double maxReducedCost = pModel_->getParameters().sp_max_reduced_cost_bound_; // max reduced cost of a rotation that would be added to MP (a tolerance is substracted in the SP)
 	vector<MyVar*> generatedColumns = pModel_->pricing(maxReducedCost, before_fathom);
 	nbGeneratedColumns_ = generatedColumns.size();
+	timerPricing.stop();
+	if(pModel_->isMetrics()){
+		std::stringstream line;
+		line << "{\"event\":\"pricing\",\"lp_it\":" << lpIteration_ << ",\"node\":" << current_index();
+		line << ",\"time\":" << timerPricing.dSinceStart() << ",\"subproblems\":" << pModel_->getLastNbSubProblemsSolved();
+		line << ",\"columns_generated\":" << nbGeneratedColumns_;
+		line << ",\"min_reduced_cost\":" << pModel_->getLastMinDualCost() << "}";
+		pModel_->writeMetrics(line.str());
+	}
+	// the next LP solve starts now
+	timerLp_.reset();
+
+	// the column generation has converged at the root node: store the basis
+	// to warm start the next solve
+	if (current_index() == 0 && nbGeneratedColumns_ == 0 && pModel_->getParameters().isLpWarmStart_) {
+		pModel_->storeLpBasis(getLpProblemPointer()->lp_solver, vars);
+	}
 
 	// Print a line summary of the solver state
 	pModel_->setCurrentTreeLevel(current_level());
@@ -502,7 +528,7 @@ void BcpLpModel::generate_vars_in_lp(const BCP_lp_result& lpres,
 
 		// LAGLB: fathom if Lagrangian bound greater than current upper bound
 		if(pModel_->getParameters().isLagrangianFathom_
-		&& pModel_->getObjective() - pModel_->getNodeLastLagLB() < pModel_->getParameters().absoluteGap_ - EPSILON){
+		&& pModel_->getPruningUB() - pModel_->getNodeLastLagLB() < pModel_->getParameters().absoluteGap_ - EPSILON){
 			nbGeneratedColumns_ = 0;
 			for(MyVar* var: generatedColumns){
 				BcpColumn* col = dynamic_cast<BcpColumn*>(var);
@@ -627,13 +653,13 @@ BCP_branching_decision BcpLpModel::select_branching_candidates(const BCP_lp_resu
 	}
 
 	//fathom if greater than current upper bound
-	if(pModel_->getObjective() - lpres.objval() < pModel_->getParameters().absoluteGap_ - EPSILON){
+	if(pModel_->getPruningUB() - lpres.objval() < pModel_->getParameters().absoluteGap_ - EPSILON){
 		return BCP_DoNotBranch_Fathomed;
 	}
 
 	//LAGLB: fathom if Lagrangian bound greater than current upper bound
 	if(pModel_->getParameters().isLagrangianFathom_
-	&& pModel_->getObjective() - pModel_->getNodeLastLagLB() < pModel_->getParameters().absoluteGap_ - EPSILON){
+	&& pModel_->getPruningUB() - pModel_->getNodeLastLagLB() < pModel_->getParameters().absoluteGap_ - EPSILON){
 		// DBG
 		std::cout << "Fathom node with Largangian bound" << std::endl;
 		return BCP_DoNotBranch_Fathomed;
@@ -850,6 +876,18 @@ void BcpLpModel::select_vars_to_delete(const BCP_lp_result& lpres,
 				if(inactive_iteration > min_inactive_iteration && activity_rate < max_activity_rate)
 					deletable.unchecked_push_back(i);
 			}
+
+	// the deleted columns may be priced again from the column pool of the pricer
+	for(int i=0; i<deletable.size(); ++i)
+		if(deletable[i] >= pModel_->getCoreVars().size())
+			pModel_->recycleColumn(dynamic_cast<BcpColumn*>(vars[deletable[i]]));
+
+	if(pModel_->isMetrics()){
+		std::stringstream line;
+		line << "{\"event\":\"delete\",\"lp_it\":" << lpIteration_ << ",\"node\":" << current_index();
+		line << ",\"columns_deleted\":" << deletable.size() << "}";
+		pModel_->writeMetrics(line.str());
+	}
 }
 
 /*
@@ -1000,6 +1038,7 @@ BcpModeler::~BcpModeler() {
          delete var;
          var = 0;
       }
+   clearLpBasis();
   delete  pBcp_;
 }
 
@@ -1008,6 +1047,9 @@ int BcpModeler::solve(bool relaxation){
    //create the root
    pTree_->pushBackNewNode();
 
+   //add the columns of the basis of the previous solve to the root
+   addLpBasisColumns();
+
    //solve
    char** argv=NULL;
 
@@ -1025,6 +1067,12 @@ int BcpModeler::solve(bool relaxation){
 		getMaster()->setStatus(TIME_LIMIT);
 	}
 
+	// the trees that share their incumbent with this one can stop, but only if this tree has completed its search:
+	// a tree stopped by the time limit or by the stopping criteria (e.g., number of solutions) has not proven anything
+	if(parameters_.sharedIncumbent_
+		&& (getMaster()->getStatus() == OPTIMAL || getMaster()->getStatus() == INFEASIBLE))
+		parameters_.sharedIncumbent_->isSearchOver_ = true;
+
 	// retrieve the statistics of the solution
 	timeStats_.add(pBcp_->getBcpLpModel()->getLpProblemPointer()->stat);
 	nbLpIterations_ = pBcp_->getBcpLpModel()->getNbLpIterations();
@@ -1048,6 +1096,9 @@ void BcpModeler::reset(bool rollingHorizon) {
    reducedCosts_.clear();
    lhsValues_.clear();
 
+   // the next solve starts without any column: they can all be priced again from the column pool
+   recycleAllColumns();
+
 	// delete the best solutions that were if solving with rolling horizon
    if (rollingHorizon) {
 		int index = getBestSolIndex();
@@ -1066,6 +1117,107 @@ void BcpModeler::reset(bool rollingHorizon) {
 
 
 
+//-----------------------------------------------------------------------------
+// LP warm start
+//-----------------------------------------------------------------------------
+
+// Store the basis of the solver and copies of the columns of vars that are
+// not at their lower bound in this basis
+//
+void BcpModeler::storeLpBasis(OsiSolverInterface* solver, const BCP_vec<BCP_var*>& vars){
+   CoinWarmStart* ws = solver->getWarmStart();
+   CoinWarmStartBasis* basis = dynamic_cast<CoinWarmStartBasis*>(ws);
+   if(!basis){
+      delete ws;
+      return;
+   }
+
+   clearLpBasis();
+   lpBasis_ = basis;
+
+   const int size = vars.size(), coreSize = coreVars_.size();
+   for(int i=coreSize; i<size; ++i){
+      CoinWarmStartBasis::Status status = basis->getStructStatus(i);
+      if(status == CoinWarmStartBasis::atLowerBound)
+         continue;
+      BcpColumn* col = dynamic_cast<BcpColumn*>(vars[i]);
+      if(!col)
+         continue;
+      lpBasisStatus_[col->getPattern()] = status;
+      lpBasisColumns_.push_back(new BcpColumn(*col));
+   }
+}
+
+// Add the stored columns to the active columns (those that are not already
+// active), and record the status of every active column, as they will be
+// ordered in the root LP
+//
+void BcpModeler::addLpBasisColumns(){
+   rootColumnsStatus_.clear();
+   if(!lpBasis_)
+      return;
+
+   set<vector<double>> patterns;
+   for(MyVar* var: activeColumnVars_)
+      patterns.insert(var->getPattern());
+
+   //the columns are given to BCP at the root: they are not owned by the model anymore
+   int index = coreVars_.size() + activeColumnVars_.size();
+   for(MyVar* var: lpBasisColumns_)
+      if(patterns.insert(var->getPattern()).second)
+         addActiveColumn(var, index++);
+      else
+         delete var;
+   lpBasisColumns_.clear();
+
+   rootColumnsStatus_.reserve(activeColumnVars_.size());
+   for(MyVar* var: activeColumnVars_){
+      map<vector<double>, CoinWarmStartBasis::Status>::const_iterator it = lpBasisStatus_.find(var->getPattern());
+      rootColumnsStatus_.push_back(it == lpBasisStatus_.end() ? CoinWarmStartBasis::atLowerBound : it->second);
+   }
+}
+
+// Build a basis of the current LP of the solver with the stored basis:
+// the core variables and rows keep their status, the columns get the status
+// they had in the stored basis and the new rows are basic
+//
+void BcpModeler::loadLpBasis(OsiSolverInterface* solver){
+   if(!lpBasis_ || rootColumnsStatus_.empty())
+      return;
+
+   const int nbCols = solver->getNumCols(), nbRows = solver->getNumRows(),
+      coreSize = coreVars_.size();
+   CoinWarmStartBasis basis;
+   basis.setSize(nbCols, nbRows);
+
+   for(int i=0; i<nbCols; ++i){
+      if(i < coreSize)
+         basis.setStructStatus(i, lpBasis_->getStructStatus(i));
+      else if(i-coreSize < rootColumnsStatus_.size())
+         basis.setStructStatus(i, rootColumnsStatus_[i-coreSize]);
+      else
+         basis.setStructStatus(i, CoinWarmStartBasis::atLowerBound);
+   }
+   for(int i=0; i<nbRows; ++i){
+      if(i < lpBasis_->getNumArtificial())
+         basis.setArtifStatus(i, lpBasis_->getArtifStatus(i));
+      else
+         basis.setArtifStatus(i, CoinWarmStartBasis::basic);
+   }
+
+   solver->setWarmStart(&basis);
+   rootColumnsStatus_.clear();
+}
+
+void BcpModeler::clearLpBasis(){
+   delete lpBasis_;
+   lpBasis_ = nullptr;
+   lpBasisStatus_.clear();
+   for(MyVar* var: lpBasisColumns_)
+      delete var;
+   lpBasisColumns_.clear();
+}
+
 /*
  * Create core variable:
  *    var is a pointer to the pointer of the variable
@@ -1200,6 +1352,8 @@ void BcpModeler::addBcpSol(const BCP_solution* sol){
    // if the solution improves the upper bound, record the new upper bound and load the integer solution
    if(pTree_->getBestUB() > sol->objective_value() + EPSILON){
       pTree_->setBestUB(sol->objective_value());
+      if(parameters_.sharedIncumbent_ && !isArtificialSol)
+         parameters_.sharedIncumbent_->update(sol->objective_value());
 
       // print the solution in a text file
       if(parameters_.printEverySolution_){
@@ -1216,6 +1370,52 @@ void BcpModeler::addBcpSol(const BCP_solution* sol){
 	}
 }
 
+// Solve the LP of each child from the current basis of the LP solver:
+// the bounds are changed in the solver and restored after each child
+//
+bool BcpModeler::evaluateChildren(const vector<vector<MyVar*>>& childrenZeroVars,
+   vector<double>& objIncreases, int maxIterations){
+   if(!pBcp_->getBcpLpModel())
+      return false;
+   OsiSolverInterface* solver = pBcp_->getBcpLpModel()->getLpProblemPointer()->lp_solver;
+   if(!solver || !solver->isProvenOptimal())
+      return false;
+
+   const double objValue = solver->getObjValue();
+   int maxIterationsHotStart;
+   solver->getIntParam(OsiMaxNumIterationHotStart, maxIterationsHotStart);
+   solver->setIntParam(OsiMaxNumIterationHotStart, maxIterations);
+   solver->markHotStart();
+
+   objIncreases.clear();
+   for(const vector<MyVar*>& vars: childrenZeroVars){
+      //set the upper bounds of the variables of the child to 0
+      vector<pair<int,double>> oldUbs;
+      for(MyVar* var: vars){
+         int index = var->getIndex();
+         if(dynamic_cast<BcpColumn*>(var))
+            index = getIndexCol(index);
+         if(index < 0 || index >= solver->getNumCols())
+            continue;
+         oldUbs.push_back(pair<int,double>(index, solver->getColUpper()[index]));
+         solver->setColUpper(index, 0);
+      }
+
+      solver->solveFromHotStart();
+      if(solver->isProvenPrimalInfeasible() || solver->isDualObjectiveLimitReached())
+         objIncreases.push_back(LARGE_SCORE);
+      else
+         objIncreases.push_back(max(0.0, solver->getObjValue() - objValue));
+
+      for(const pair<int,double>& p: oldUbs)
+         solver->setColUpper(p.first, p.second);
+   }
+
+   solver->unmarkHotStart();
+   solver->setIntParam(OsiMaxNumIterationHotStart, maxIterationsHotStart);
+   return true;
+}
+
 // Get the index of the best solution in the vector of solutions of BCP
 //
 int BcpModeler::getBestSolIndex() {
@@ -1463,6 +1663,12 @@ double BcpModeler::getDual(MyCons* cons, bool transformed){
    return dualValues_[cons2->getIndex()];
 }
 
+const double* BcpModeler::getDualValues(){
+   if(dualValues_.size() == 0)
+      Tools::throwError("Dual solution has been initialized.");
+   return dualValues_.data();
+}
+
 /*
  * Get the reduced cost
  */
@@ -1544,19 +1750,23 @@ int BcpModeler::setVerbosity(int v){
 
 //Check if BCP must stop
 bool BcpModeler::doStop(){
+   //stop if another tree exploring the same problem has completed its search
+   if(parameters_.sharedIncumbent_ && parameters_.sharedIncumbent_->isSearchOver_)
+      throw FeasibleStop("Stopped: the search has been completed by another tree.");
+
    //continue if doesn't have a lb
    if(pTree_->getBestLB() >= LARGE_SCORE)
       return false;
 
    //check relative gap
-	if(pTree_->getBestUB() - pTree_->getBestLB() < parameters_.absoluteGap_ - EPSILON){
+	if(getPruningUB() - pTree_->getBestLB() < parameters_.absoluteGap_ - EPSILON){
       char error[100];
       sprintf(error, "Stopped: absolute gap < %.2f.", parameters_.absoluteGap_);
       throw OptimalStop(error);
    }
-	else if (getMaster()->getTimerTotal()->dSinceStart() > getParameters().maxSolvingTimeSeconds_ ) {
+	else if (getMaster()->getDeadline()->isExpired()) {
 		char error[100];
-		std::cout << "Total time spent solving the problem " << getMaster()->getTimerTotal()->dSinceStart() << std::endl;
+		std::cout << "Total time spent solving the problem " << getMaster()->getDeadline()->elapsed() << std::endl;
       sprintf(error, "Stopped: Time has run out.");
       throw TimeoutStop(error);
 	}
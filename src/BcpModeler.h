@@ -23,6 +23,7 @@
 #include "BCP_USER.hpp"
 #include "BCP_solution.hpp"
 #include "OsiClpSolverInterface.hpp"
+#include "CoinWarmStartBasis.hpp"
 #include "CoinSearchTree.hpp"
 
 
@@ -155,15 +156,16 @@ struct BcpColumn: public CoinVar, public BCP_var_algo{
 	}
 
 	void pack(BCP_buffer& buf){
-		buf.pack(name_);
+		string name = getName();
+		buf.pack(name.c_str());
       buf.pack(index_);
 		buf.pack(_var_type);
 		buf.pack(cost_);
 		buf.pack(lb_);
 		buf.pack(ub_);
 		buf.pack(dualCost_);
-		buf.pack(indexRows_);
-		buf.pack(coeffs_);
+		buf.pack(column_->indexRows_);
+		buf.pack(column_->coeffs_);
 		buf.pack(pattern_);
 		buf.pack(iteration_creation_);
 		buf.pack(active_count_);
@@ -302,6 +304,8 @@ public:
 
 	double getDual(MyCons* cons, bool transformed = false);
 
+	const double* getDualValues();
+
 	/*
 	 * Get the reduced cost
 	 */
@@ -341,6 +345,10 @@ public:
 
 	void addBcpSol(const BCP_solution* sol);
 
+	//strong branching with the hot start of the LP solver
+	bool evaluateChildren(const vector<vector<MyVar*>>& childrenZeroVars,
+		vector<double>& objIncreases, int maxIterations);
+
 	// Get the index of the best solution in the vector of solutions of BCP
 	int getBestSolIndex();
 
@@ -451,6 +459,15 @@ public:
 	//check if Bcp stops
 	bool doStop();
 
+	//upper bound used to fathom the nodes: the best one among this tree and
+	//the trees that share their incumbent with it
+	double getPruningUB() {
+		double ub = pTree_->getBestUB();
+		if(parameters_.sharedIncumbent_)
+			ub = min(ub, parameters_.sharedIncumbent_->ub_.load());
+		return ub;
+	}
+
 	//check the active rotations
 	void checkActiveColumns(const BCP_vec<BCP_var*>&  vars);
 
@@ -480,6 +497,16 @@ public:
 	//
 	BcpLpSol* getRootSolution() {return &rootSolution_;}
 
+	// LP warm start
+	// Store the basis of the last LP of the root node and copies of its columns
+	// that are not at their lower bound, add these columns to the active columns
+	// of the next solve and warm start its first LP with the stored basis
+	//
+	void storeLpBasis(OsiSolverInterface* solver, const BCP_vec<BCP_var*>& vars);
+	void addLpBasisColumns();
+	void loadLpBasis(OsiSolverInterface* solver);
+	void clearLpBasis();
+
 	// Get/set statistics
 	//
 	BCP_lp_statistics getTimeStats() {return timeStats_;}
@@ -511,6 +538,14 @@ protected:
 	// bcp solution of the root node
 	BcpLpSol rootSolution_;
 
+	// LP warm start: basis of the last root LP, status of its columns that are
+	// not at their lower bound (indexed by pattern) and copies of these columns,
+	// status of the active columns given to the root of the current solve
+	CoinWarmStartBasis* lpBasis_ = nullptr;
+	map<vector<double>, CoinWarmStartBasis::Status> lpBasisStatus_;
+	vector<MyVar*> lpBasisColumns_;
+	vector<CoinWarmStartBasis::Status> rootColumnsStatus_;
+
 
 	/* stats */
 	//number of sub problems solved on the last iteration of column generation
@@ -786,6 +821,8 @@ protected:
 	int nbNodesSinceLastHeuristic_;
 	//number of generated columns
 	int nbGeneratedColumns_;
+	//time spent since the end of the last pricing, i.e. in the LP solve
+	Tools::Timer timerLp_;
 	// Number of dives to wait before branching on columns again
 	list<int> nb_dives_to_wait_before_branching_on_columns_;
 
@@ -0,0 +1,480 @@
+//
+//  BenchmarkMain.cpp
+//  RosterDesNurses
+//
+//  Run the deterministic solver over a matrix of instances, parameter files and
+//  seeds, and compare the results with a baseline to detect regressions.
+//
+//  Usage:
+//    nursescheduler_bench --matrix <file> [--out <file>] [--baseline <file>]
+//                         [--tolerance <relative>] [--logdir <dir>]
+//                         [--threads <nb>] [--memory <MB>]
+//
+//  The matrix file contains one keyword per line ('#' starts a comment):
+//    dir datasets/                  directory of the data sets
+//    instance n030w4_1-2-3-3_0      instance to solve (data_weeks_history), repeated
+//    param paramfiles/default.txt   parameter file, repeated
+//    seeds 0 1 2                    random seeds
+//    timeout 60                     time limit of each run in seconds
+//
+//  Every run is executed in a child process so that the peak resident memory is
+//  measured per run and no static state leaks from one run to the next.
+//  The results file has the same format as the baseline file, so the results of
+//  a reference version can be used as baseline of the next ones.
+//
+//  With --threads, the runs are instead executed as jobs of a pool of threads
+//  within this process: each scenario file is read only once and every job
+//  solves its own copy, and no new job is started while the resident memory of
+//  the process exceeds the budget given with --memory. The peak RSS of a run
+//  cannot be isolated in this mode: it is reported as 0 and not compared with
+//  the baseline. The results are written in --out as soon as each job ends.
+//
+
+#include "InitializeSolver.h"
+#include "MyTools.h"
+#include "DeterministicSolver.h"
+#include "GlobalStats.h"
+#include "ReadWrite.h"
+#include "SubProblem.h"
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <thread>
+
+#include <fcntl.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+
+/******************************************************************************
+* Description and results of a run of the benchmark
+******************************************************************************/
+
+struct BenchRun {
+	// description of the run
+	string instance_;
+	string param_;
+	int seed_=0;
+
+	// results of the run
+	string status_="FAILED";
+	double time_=0.0;
+	double rootLB_=0.0;
+	double bestUB_=0.0;
+	double bestLB_=0.0;
+	double gap_=0.0;
+	int nodes_=0;
+	int pricingRounds_=0;
+	long peakRSS_=0;
+
+	// key used to match a run with the baseline
+	string key() const {
+		std::stringstream key;
+		key << instance_ << " " << param_ << " " << seed_;
+		return key.str();
+	}
+
+	string toString() const {
+		std::stringstream rep;
+		rep << instance_ << "\t" << param_ << "\t" << seed_ << "\t" << status_ << "\t";
+		rep << time_ << "\t" << rootLB_ << "\t" << bestUB_ << "\t" << bestLB_ << "\t" << gap_ << "\t";
+		rep << nodes_ << "\t" << pricingRounds_ << "\t" << peakRSS_;
+		return rep.str();
+	}
+
+	// read a line written by toString()
+	bool fromString(const string& line) {
+		std::istringstream rep(line);
+		rep >> instance_ >> param_ >> seed_ >> status_;
+		rep >> time_ >> rootLB_ >> bestUB_ >> bestLB_ >> gap_;
+		rep >> nodes_ >> pricingRounds_ >> peakRSS_;
+		return !rep.fail();
+	}
+};
+
+static const string benchHeader =
+	"#instance\tparam\tseed\tstatus\ttime\trootLB\tbestUB\tbestLB\tgap\tnodes\tpricingRounds\tpeakRSS(kB)";
+
+
+/******************************************************************************
+* Read the matrix of runs
+******************************************************************************/
+
+vector<BenchRun> readBenchMatrix(string matrixFile, string& dataDir, double& timeout) {
+	std::fstream file(matrixFile.c_str(), std::fstream::in);
+	if (!file.is_open()) {
+		Tools::throwError("readBenchMatrix: the matrix file " + matrixFile + " cannot be opened!");
+	}
+
+	vector<string> instances, params;
+	vector<int> seeds;
+	string line;
+	while (std::getline(file, line)) {
+		std::istringstream words(line);
+		string title;
+		if (!(words >> title) || title[0] == '#') continue;
+
+		if (title == "dir") words >> dataDir;
+		else if (title == "instance") {
+			string instance;
+			words >> instance;
+			instances.push_back(instance);
+		}
+		else if (title == "param") {
+			string param;
+			words >> param;
+			params.push_back(param);
+		}
+		else if (title == "seeds") {
+			int seed;
+			while (words >> seed) seeds.push_back(seed);
+		}
+		else if (title == "timeout") words >> timeout;
+		else {
+			Tools::throwError("readBenchMatrix: unknown keyword " + title + " in " + matrixFile);
+		}
+	}
+	if (params.empty()) params.push_back("paramfiles/default.txt");
+	if (seeds.empty()) seeds.push_back(0);
+
+	vector<BenchRun> runs;
+	for (string instance: instances)
+		for (string param: params)
+			for (int seed: seeds) {
+				BenchRun run;
+				run.instance_ = instance;
+				run.param_ = param;
+				run.seed_ = seed;
+				runs.push_back(run);
+			}
+	return runs;
+}
+
+
+/******************************************************************************
+* Scenarios shared by the jobs of the batch mode: each scenario file is read
+* once, and the jobs solve copies that share its contracts
+******************************************************************************/
+
+class ScenarioCache {
+public:
+	~ScenarioCache() {
+		for (pair<const string, Scenario*>& p: scenarios_) delete p.second;
+	}
+
+	Scenario* getScenario(string scenarioFile) {
+		std::lock_guard<std::mutex> lock(mutex_);
+		map<string, Scenario*>::iterator it = scenarios_.find(scenarioFile);
+		if (it != scenarios_.end()) return it->second;
+		Scenario* pScenario = ReadWrite::readScenario(scenarioFile);
+		scenarios_[scenarioFile] = pScenario;
+		return pScenario;
+	}
+
+private:
+	std::mutex mutex_;
+	map<string, Scenario*> scenarios_;
+};
+
+
+/******************************************************************************
+* Solve one instance as the static scheduler does and return the statistics.
+* The instance is described as data_weeks_history, e.g. n030w4_1-2-3-3_0.
+******************************************************************************/
+
+GlobalStats solveBenchInstance(const BenchRun& run, string dataDir, double timeout, ScenarioCache* pCache = 0) {
+	vector<string> fields;
+	std::istringstream description(run.instance_);
+	string field;
+	while (std::getline(description, field, '_')) fields.push_back(field);
+	if (fields.size() != 3) {
+		Tools::throwError("solveBenchInstance: the instance " + run.instance_ + " should follow the pattern data_weeks_history");
+	}
+
+	InputPaths inputPaths(dataDir, fields[0], std::stoi(fields[2]), Tools::parseList(fields[1],'-'),
+		"", "", run.param_, timeout, run.seed_);
+
+	Scenario* pScenario = 0;
+	if (pCache) {
+		// copy the cached scenario and read the weeks and history of this run only
+		pScenario = new Scenario(pCache->getScenario(inputPaths.scenario()));
+		ReadWrite::readWeeks(inputPaths.weeks(), pScenario);
+		ReadWrite::readHistory(inputPaths.history(), pScenario);
+	}
+	else {
+		pScenario = (inputPaths.nbWeeks() > 1) ? initializeMultipleWeeks(inputPaths) : initializeScenario(inputPaths);
+	}
+	Tools::initializeRandomGenerator(inputPaths.randSeed());
+	srand(inputPaths.randSeed());
+
+	DeterministicSolver* pSolver = new DeterministicSolver(pScenario, inputPaths);
+	pSolver->solve();
+	GlobalStats stats = pSolver->getGlobalStat();
+	stats.status_ = pSolver->getStatus();
+
+	delete pSolver;
+	delete pScenario;
+	return stats;
+}
+
+
+/******************************************************************************
+* Run one element of the matrix in a child process
+******************************************************************************/
+
+// seconds elapsed since start on the steady clock
+double secondsSince(std::chrono::steady_clock::time_point start) {
+	return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+void runInChildProcess(BenchRun& run, string dataDir, double timeout, string logDir) {
+	int fds[2];
+	if (pipe(fds)) Tools::throwError("runInChildProcess: cannot create a pipe!");
+
+	// wall-clock time of the run: the time of the child is not counted in the CPU time of this process
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	pid_t pid = fork();
+	if (pid < 0) Tools::throwError("runInChildProcess: cannot fork!");
+
+	if (pid == 0) {
+		// child: solve silently and send the statistics to the parent
+		close(fds[0]);
+		string logFile = logDir.empty() ? "/dev/null" : logDir + "/" + run.instance_ + "_" + std::to_string(run.seed_) + ".log";
+		if (!freopen(logFile.c_str(), "w", stdout)) _exit(2);
+
+		int exitCode = 0;
+		std::stringstream rep;
+		try {
+			GlobalStats stats = solveBenchInstance(run, dataDir, timeout);
+			rep << statusToString[stats.status_] << " " << stats.rootLB_ << " " << stats.bestUB_ << " " << stats.bestLB_;
+			rep << " " << stats.nodesBBInitial_+stats.nodesBBImprove_ << " " << stats.itGenColInitial_+stats.itGenColImprove_;
+		}
+		catch (...) {
+			exitCode = 1;
+		}
+		std::cout.flush();
+		string str = rep.str();
+		if (write(fds[1], str.c_str(), str.size()) < 0) exitCode = 2;
+		close(fds[1]);
+		_exit(exitCode);
+	}
+
+	// parent: read the statistics and the resources used by the child
+	close(fds[1]);
+	string rep;
+	char buffer[256];
+	ssize_t n;
+	while ((n = read(fds[0], buffer, sizeof(buffer))) > 0) rep.append(buffer, n);
+	close(fds[0]);
+
+	int childStatus;
+	struct rusage usage;
+	wait4(pid, &childStatus, 0, &usage);
+
+	run.time_ = secondsSince(start);
+	run.peakRSS_ = usage.ru_maxrss;
+	if (WIFEXITED(childStatus) && WEXITSTATUS(childStatus) == 0) {
+		std::istringstream stats(rep);
+		stats >> run.status_ >> run.rootLB_ >> run.bestUB_ >> run.bestLB_ >> run.nodes_ >> run.pricingRounds_;
+		run.gap_ = (run.bestUB_ > EPSILON) ? (run.bestUB_-run.bestLB_)/run.bestUB_ : 0.0;
+	}
+}
+
+
+/******************************************************************************
+* Run all the elements of the matrix in a pool of threads of this process.
+* The results are written in the output stream as soon as each run ends.
+******************************************************************************/
+
+// current resident memory of the process in kB
+long currentRSS() {
+	long size = 0, resident = 0;
+	std::ifstream statm("/proc/self/statm");
+	if (!(statm >> size >> resident)) return 0;
+	return resident * (sysconf(_SC_PAGESIZE) / 1024);
+}
+
+void runInWorkerPool(vector<BenchRun>& runs, string dataDir, double timeout, int nbThreads,
+	long memoryBudget, Tools::LogOutput& outStream) {
+	ScenarioCache cache;
+	std::mutex outMutex;
+	std::atomic<int> nextRun(0), nbRunning(0);
+
+	auto worker = [&]() {
+		while (true) {
+			// wait for the memory to go below the budget, unless the pool is idle
+			while (memoryBudget > 0 && nbRunning > 0 && currentRSS() > memoryBudget)
+				std::this_thread::sleep_for(std::chrono::milliseconds(100));
+			int r = nextRun++;
+			if (r >= (int) runs.size()) return;
+			++nbRunning;
+
+			BenchRun& run = runs[r];
+			// wall-clock time of the run: the CPU time would include the other workers
+			std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+			try {
+				GlobalStats stats = solveBenchInstance(run, dataDir, timeout, &cache);
+				run.status_ = statusToString[stats.status_];
+				run.rootLB_ = stats.rootLB_;
+				run.bestUB_ = stats.bestUB_;
+				run.bestLB_ = stats.bestLB_;
+				run.nodes_ = stats.nodesBBInitial_+stats.nodesBBImprove_;
+				run.pricingRounds_ = stats.itGenColInitial_+stats.itGenColImprove_;
+				run.gap_ = (run.bestUB_ > EPSILON) ? (run.bestUB_-run.bestLB_)/run.bestUB_ : 0.0;
+			}
+			catch (...) {
+				run.status_ = "FAILED";
+			}
+			run.time_ = secondsSince(start);
+			run.peakRSS_ = 0;
+			--nbRunning;
+
+			std::lock_guard<std::mutex> lock(outMutex);
+			std::cerr << "# DONE " << run.key() << " " << run.status_ << std::endl;
+			outStream << run.toString() << std::endl;
+		}
+	};
+
+	vector<std::thread> threads;
+	for (int t = 0; t < nbThreads; ++t) threads.push_back(std::thread(worker));
+	for (std::thread& thread: threads) thread.join();
+
+	// the skeletons of the subproblems are not needed after the batch
+	SubProblem::clearSkeletonCache();
+}
+
+
+/******************************************************************************
+* Compare the runs with the baseline and return the number of regressions.
+* The runtime and the memory can increase by the relative tolerance, while the
+* bounds and the gap must not degrade. The memory is not compared when it has
+* not been measured (batch mode).
+******************************************************************************/
+
+int compareWithBaseline(const vector<BenchRun>& runs, string baselineFile, double tolerance) {
+	std::fstream file(baselineFile.c_str(), std::fstream::in);
+	if (!file.is_open()) {
+		Tools::throwError("compareWithBaseline: the baseline file " + baselineFile + " cannot be opened!");
+	}
+	map<string, BenchRun> baseline;
+	string line;
+	while (std::getline(file, line)) {
+		BenchRun run;
+		if (line.empty() || line[0] == '#' || !run.fromString(line)) continue;
+		baseline[run.key()] = run;
+	}
+
+	int nbRegressions = 0;
+	for (const BenchRun& run: runs) {
+		map<string, BenchRun>::iterator it = baseline.find(run.key());
+		if (it == baseline.end()) {
+			std::cout << "NEW        " << run.key() << std::endl;
+			continue;
+		}
+		const BenchRun& base = it->second;
+
+		std::stringstream reasons;
+		if (run.status_ != base.status_)
+			reasons << " status " << base.status_ << " -> " << run.status_ << ";";
+		if (run.bestUB_ > base.bestUB_ + EPSILON)
+			reasons << " UB " << base.bestUB_ << " -> " << run.bestUB_ << ";";
+		if (run.rootLB_ < base.rootLB_ - EPSILON)
+			reasons << " root LB " << base.rootLB_ << " -> " << run.rootLB_ << ";";
+		if (run.gap_ > base.gap_ + EPSILON)
+			reasons << " gap " << base.gap_ << " -> " << run.gap_ << ";";
+		if (run.time_ > (1+tolerance) * base.time_)
+			reasons << " time " << base.time_ << " -> " << run.time_ << ";";
+		if (run.peakRSS_ > 0 && base.peakRSS_ > 0 && run.peakRSS_ > (1+tolerance) * base.peakRSS_)
+			reasons << " peak RSS " << base.peakRSS_ << " -> " << run.peakRSS_ << ";";
+
+		if (reasons.str().empty()) {
+			std::cout << "OK         " << run.key() << std::endl;
+		}
+		else {
+			++nbRegressions;
+			std::cout << "REGRESSION " << run.key() << ":" << reasons.str() << std::endl;
+		}
+	}
+	return nbRegressions;
+}
+
+
+/******************************************************************************
+* Main method
+******************************************************************************/
+
+int main(int argc, char** argv)
+{
+	std::cout << "# BENCHMARK OF THE DETERMINISTIC SOLVER" << std::endl;
+
+	// Detect errors in the number of arguments
+	//
+	if (argc%2 != 1) {
+		Tools::throwError("main: There should be an even number of arguments!");
+	}
+
+	string matrixFile = "", outFile = "", baselineFile = "", logDir = "", dataDir = "datasets/";
+	double tolerance = 0.1, timeout = 60.0;
+	int nbThreads = 0;
+	long memoryBudget = 0;
+	for (int narg = 1; narg < argc; narg += 2) {
+		const char* arg = argv[narg];
+		if (!strcmp(arg,"--matrix")) matrixFile = argv[narg+1];
+		else if (!strcmp(arg,"--out")) outFile = argv[narg+1];
+		else if (!strcmp(arg,"--baseline")) baselineFile = argv[narg+1];
+		else if (!strcmp(arg,"--tolerance")) tolerance = std::stod(argv[narg+1]);
+		else if (!strcmp(arg,"--logdir")) logDir = argv[narg+1];
+		else if (!strcmp(arg,"--threads")) nbThreads = std::stoi(argv[narg+1]);
+		else if (!strcmp(arg,"--memory")) memoryBudget = 1024 * std::stol(argv[narg+1]);
+		else {
+			std::stringstream err_buff;
+			err_buff << "main: the argument (" << arg << ") does not match the expected list!";
+			Tools::throwError(err_buff.str());
+		}
+	}
+	if (matrixFile.empty()) {
+		Tools::throwError("main: the matrix of the benchmark must be given with --matrix!");
+	}
+
+	// Run all the elements of the matrix
+	//
+	vector<BenchRun> runs = readBenchMatrix(matrixFile, dataDir, timeout);
+	if (nbThreads > 0 && outFile.empty()) {
+		Tools::throwError("main: the batch mode (--threads) needs an output file given with --out!");
+	}
+	Tools::LogOutput outStream(outFile);
+	outStream << benchHeader << std::endl;
+	if (nbThreads > 0) {
+		// the solvers of all the jobs write in the same log, the standard output
+		// is restored for the comparison with the baseline
+		std::cout << "# BATCH OF " << runs.size() << " RUNS ON " << nbThreads << " THREADS" << std::endl;
+		int stdoutCopy = dup(STDOUT_FILENO);
+		string logFile = logDir.empty() ? "/dev/null" : logDir + "/batch.log";
+		if (!freopen(logFile.c_str(), "w", stdout)) {
+			Tools::throwError("main: cannot redirect the standard output to " + logFile);
+		}
+		runInWorkerPool(runs, dataDir, timeout, nbThreads, memoryBudget, outStream);
+		std::cout.flush();
+		fflush(stdout);
+		dup2(stdoutCopy, STDOUT_FILENO);
+		close(stdoutCopy);
+	}
+	else {
+		for (BenchRun& run: runs) {
+			std::cout << "# RUN " << run.key() << std::endl;
+			runInChildProcess(run, dataDir, timeout, logDir);
+			outStream << run.toString() << std::endl;
+		}
+	}
+	outStream.close();
+
+	// Compare with the baseline: the exit code is the number of regressions
+	//
+	if (baselineFile.empty()) return 0;
+	std::cout << "# COMPARISON WITH THE BASELINE " << baselineFile << std::endl;
+	int nbRegressions = compareWithBaseline(runs, baselineFile, tolerance);
+	std::cout << "# " << nbRegressions << " regression(s) out of " << runs.size() << " runs" << std::endl;
+	return std::min(nbRegressions, 255);
+}
@@ -10,6 +10,8 @@
 
 #include "Modeler.h"
 
+#include <memory>
+
 /* Coin includes */
 #include <CoinPackedMatrix.hpp>
 
@@ -33,16 +35,29 @@ public:
 /*
 * My Variables
 */
+//Sparse column of a Coin var: the rows of the matrix where the variable has a non-zero
+//coefficient and the values of these coefficients, stored contiguously.
+//The column is shared by all the copies of a variable and is only copied when one of them adds a row.
+struct CoinColumn {
+	CoinColumn(const vector<int>& indexRows, const vector<double>& coeffs):
+	indexRows_(indexRows), coeffs_(coeffs)
+	{ }
+
+	vector<int> indexRows_; //index of the rows of the matrix where the variable has non-zero coefficient
+	vector<double> coeffs_; //value of these coefficients
+};
+
 //Coin var, just a virtual class
 struct CoinVar: public MyVar {
 	CoinVar(const char* name, int index, double cost, VarType type, double lb, double ub,
 	const vector<double>& pattern = DEFAULT_PATTERN, double dualCost = 99999,
 	const vector<int>& indexRows = Tools::EMPTY_INT_VECTOR, const vector<double>& coeffs = Tools::EMPTY_DOUBLE_VECTOR):
-	MyVar(name, index, cost, type, lb, ub, pattern), dualCost_(dualCost), indexRows_(indexRows), coeffs_(coeffs)
+	MyVar(name, index, cost, type, lb, ub, pattern), dualCost_(dualCost), column_(std::make_shared<CoinColumn>(indexRows, coeffs))
 	{ }
 
+	//the copy shares the column of var
 	CoinVar(const CoinVar& var) :
-	MyVar(var), dualCost_(var.dualCost_), indexRows_(var.indexRows_), coeffs_(var.coeffs_)
+	MyVar(var), dualCost_(var.dualCost_), column_(var.column_)
 	{ }
 
 	virtual ~CoinVar(){ }
@@ -52,31 +67,33 @@ struct CoinVar: public MyVar {
 	*/
 
 	void addRow(int index, double coeff){
-		indexRows_.push_back(index);
-		coeffs_.push_back(coeff);
+		//copy on write: detach the column if it is shared with another var
+		if(column_.use_count() > 1)
+		column_ = std::make_shared<CoinColumn>(column_->indexRows_, column_->coeffs_);
+		column_->indexRows_.push_back(index);
+		column_->coeffs_.push_back(coeff);
 	}
 
 	void toString(vector<CoinCons*>& cons) {
-		cout << name_ << ":";
-		for(int i=0; i<indexRows_.size(); ++i)
-		cout << " " << cons[indexRows_[i]]->name_ << ":" << coeffs_[i];
+		cout << getName() << ":";
+		for(int i=0; i<column_->indexRows_.size(); ++i)
+		cout << " " << cons[column_->indexRows_[i]]->getName() << ":" << column_->coeffs_[i];
 		cout << endl;
 	}
 
-	int getNbRows() { return indexRows_.size(); }
+	int getNbRows() const { return column_->indexRows_.size(); }
 
-	vector<int>& getIndexRows() { return indexRows_; }
+	const vector<int>& getIndexRows() const { return column_->indexRows_; }
 
-	int getIndexRow(int i) { return indexRows_[i]; }
+	int getIndexRow(int i) const { return column_->indexRows_[i]; }
 
-	vector<double>& getCoeffRows() { return coeffs_; }
+	const vector<double>& getCoeffRows() const { return column_->coeffs_; }
 
-	double getCoeffRow(int i) { return coeffs_[i]; }
+	double getCoeffRow(int i) const { return column_->coeffs_[i]; }
 
 protected:
 	double dualCost_; //dualCost of the variable
-	vector<int> indexRows_; //index of the rows of the matrix where the variable has non-zero coefficient
-	vector<double> coeffs_; //value of these coefficients
+	std::shared_ptr<CoinColumn> column_; //sparse column of the variable in the matrix
 };
 
 class CoinModeler: public Modeler {
@@ -220,6 +237,8 @@ public:
 
 	virtual double getDual(MyCons* cons, bool transformed = false) { return 0; }
 
+	virtual const double* getDualValues() { return 0; }
+
 	/*
 	* Get the reduced cost
 	*/
@@ -241,7 +260,7 @@ public:
 
 		double value = getVarValue(var);
 		if(print && value>EPSILON)
-		cout << var->name_ << ": " << value << "*" << var2->getCost() << endl;
+		cout << var->getName() << ": " << value << "*" << var2->getCost() << endl;
 		return value *  var2->getCost();
 	}
 
@@ -275,13 +294,13 @@ public:
 			for(CoinVar* var: coreVars_){
 				double value = getVarValue(var);
 				if( value > tolerance)
-				fprintf(pFile,"%-30s %4.2f (%6.0f) \n", var->name_ , value, var->getCost());
+				fprintf(pFile,"%-30s %4.2f (%6.0f) \n", var->getName().c_str() , value, var->getCost());
 			}
 			//iterate on column variables
 			for(MyVar* var: activeColumnVars_){
 				double value = getVarValue(var);
 				if( value > tolerance)
-				fprintf(pFile,"%-30s %4.2f (%6.0f) \n", var->name_ , value, var->getCost());
+				fprintf(pFile,"%-30s %4.2f (%6.0f) \n", var->getName().c_str() , value, var->getCost());
 			}
 
 			fprintf(pFile,"\n");
@@ -10,6 +10,10 @@
 #include "MasterProblem.h"
 #include "InitializeSolver.h"
 
+#include <thread>
+#include <mutex>
+#include <exception>
+
 // #define COMPARE_EVALUATIONS
 
 //-----------------------------------------------------------------------------
@@ -55,6 +59,8 @@ DeterministicSolver::~DeterministicSolver(){
 	if(pCompleteSolver_) delete pCompleteSolver_;
 	if(pRollingSolver_) delete pRollingSolver_;
 	// DBG if (pLNSSolver_) delete pLNSSolver_;
+	for (Solver* pSolver: lnsWorkers_)
+		if (pSolver != pCompleteSolver_ && pSolver != pRollingSolver_) delete pSolver;
 }
 
 
@@ -127,6 +133,12 @@ void DeterministicSolver::readOptionsFromFile(InputPaths& inputPaths) {
 		if(Tools::strEndsWith(title, "divideIntoConnexPositions")){
 			file >> options_.divideIntoConnexPositions_;
 		}
+		else if (Tools::strEndsWith(title, "nbComponentThreads")) {
+			file >> options_.nbComponentThreads_;
+		}
+		else if (Tools::strEndsWith(title, "nbTreeWorkers")) {
+			file >> options_.nbTreeWorkers_;
+		}
 		else if (Tools::strEndsWith(title, "withRollingHorizon")) {
 			file >> options_.withRollingHorizon_;
 		}
@@ -169,6 +181,9 @@ void DeterministicSolver::readOptionsFromFile(InputPaths& inputPaths) {
 		else if (Tools::strEndsWith(title, "lnsNbNursesDestroyOverFourWeeks")) {
 			file >> options_.lnsNbNursesDestroyOverFourWeeks_;
 		}
+		else if (Tools::strEndsWith(title, "lnsNbWorkers")) {
+			file >> options_.lnsNbWorkers_;
+		}
 		else if (Tools::strEndsWith(title, "lnsNbNursesDestroyOverAllWeeks")) {
 			file >> options_.lnsNbNursesDestroyOverAllWeeks_;
 		}
@@ -205,9 +220,21 @@ void DeterministicSolver::readOptionsFromFile(InputPaths& inputPaths) {
 		else if (Tools::strEndsWith(title, "branchColumnUntilValue")) {
 			file >> param.branchColumnUntilValue_;
 		}
+		else if (Tools::strEndsWith(title, "strongBranchingNbCandidates")) {
+			file >> param.strongBranchingNbCandidates_;
+		}
+		else if (Tools::strEndsWith(title, "strongBranchingMaxIterations")) {
+			file >> param.strongBranchingMaxIterations_;
+		}
+		else if (Tools::strEndsWith(title, "strongBranchingReliability")) {
+			file >> param.strongBranchingReliability_;
+		}
 		else if (Tools::strEndsWith(title, "stopAfterXDegenerateIt")) {
 			file >> param.stopAfterXDegenerateIt_;
 		}
+		else if (Tools::strEndsWith(title, "isLpWarmStart")) {
+			file >> param.isLpWarmStart_;
+		}
 		else if (Tools::strEndsWith(title, "heuristicMinIntegerPercent")) {
 			file >> param.heuristicMinIntegerPercent_;
 		}
@@ -248,6 +275,21 @@ void DeterministicSolver::readOptionsFromFile(InputPaths& inputPaths) {
 		else if (Tools::strEndsWith(title, "spMaxReducedCostBound")) {
 			file >> param.sp_max_reduced_cost_bound_;
 		}
+		else if (Tools::strEndsWith(title, "metricsFile")) {
+			file >> param.metricsfile_;
+		}
+		else if (Tools::strEndsWith(title, "spNbThreads")) {
+			file >> param.sp_nbthreads_;
+		}
+		else if (Tools::strEndsWith(title, "spLayeredLabeling")) {
+			file >> param.sp_layered_labeling_;
+		}
+		else if (Tools::strEndsWith(title, "spBidirectionalLabeling")) {
+			file >> param.sp_bidirectional_labeling_;
+		}
+		else if (Tools::strEndsWith(title, "spColumnPoolSize")) {
+			file >> param.sp_column_pool_size_;
+		}
 	}
 	options_.totalTimeLimitSeconds_ = inputPaths.timeOut();
 	param.maxSolvingTimeSeconds_ = options_.totalTimeLimitSeconds_;
@@ -321,6 +363,13 @@ void DeterministicSolver::updateImproveStats(MasterProblem* pMaster) {
 	}
 }
 
+// Wall-clock and CPU times of the last solution of the run
+//
+void DeterministicSolver::updateTimeStats() {
+	stats_.timeTotal_ = pDeadline_->elapsed();
+	stats_.cpuTimeTotal_ = Tools::cpuTime() - cpuTimeAtStart_;
+}
+
 
 //----------------------------------------------------------------------------
 //
@@ -334,12 +383,20 @@ double DeterministicSolver::solve(vector<Roster> initialSolution){
 
 	objValue_ = 0.0;
 
+	// start the wall-clock deadline of the run, every solution process carves
+	// its own time limit from it
+	//
+	this->startDeadline(options_.totalTimeLimitSeconds_);
+	completeParameters_.pDeadline_ = pDeadline_;
+	rollingParameters_.pDeadline_ = pDeadline_;
+	lnsParameters_.pDeadline_ = pDeadline_;
+	cpuTimeAtStart_ = Tools::cpuTime();
+
 	// set the random seed to the same fixed value for every solution of a new
 	// scenario
 	// this is absolutely necessary for reproductibility of the results
 	//
 	Tools::initializeRandomGenerator(this->options_.randomSeed_);
-	srand(this->options_.randomSeed_);
 
 	// DBG
 	std::cout << "Next random : " << Tools::randomInt(0, RAND_MAX) << std::endl;
@@ -355,6 +412,7 @@ double DeterministicSolver::solve(vector<Roster> initialSolution){
 		if (MasterProblem* pMaster = dynamic_cast<MasterProblem*> (pCompleteSolver_)) {
 			this->updateInitialStats(pMaster);
 		}
+		this->updateTimeStats();
 		return objValue_;
 	}
 
@@ -384,6 +442,7 @@ double DeterministicSolver::solve(vector<Roster> initialSolution){
 			}
 			// do not bother improving the solution if it is already optimal
 			if (status_ == OPTIMAL) {
+				this->updateTimeStats();
 				return objValue_;
 			}
 		}
@@ -398,6 +457,7 @@ double DeterministicSolver::solve(vector<Roster> initialSolution){
 			}
 		}
 	}
+	this->updateTimeStats();
 	return objValue_;
 }
 
@@ -410,6 +470,10 @@ double DeterministicSolver::solve(vector<Roster> initialSolution){
 
 double DeterministicSolver::solveCompleteHorizon() {
 
+	if (options_.nbTreeWorkers_ > 1 && options_.solutionAlgorithm_ == GENCOL) {
+		return solveCompleteHorizonInParallel();
+	}
+
 	// Initialize solver and solve
 	//
 	pCompleteSolver_ = setSolverWithInputAlgorithm(pDemand_);
@@ -418,6 +482,77 @@ double DeterministicSolver::solveCompleteHorizon() {
 	return this->treatResults(pCompleteSolver_);
 }
 
+double DeterministicSolver::solveCompleteHorizonInParallel() {
+
+	int nbWorkers = options_.nbTreeWorkers_;
+	SharedIncumbent incumbent;
+
+	// Each worker dives differently: the odd workers swap the column branching
+	// rule and the workers from the third one on explore the tree depth first
+	//
+	std::vector<Solver*> workers(nbWorkers);
+	std::vector<SolverParam> params(nbWorkers, completeParameters_);
+	for (int w=0; w < nbWorkers; w++) {
+		workers[w] = setSolverWithInputAlgorithm(pDemand_);
+		params[w].sharedIncumbent_ = &incumbent;
+		if (w%2 == 1) {
+			params[w].branchColumnDisjoint_ = !completeParameters_.branchColumnDisjoint_;
+			params[w].branchColumnUntilValue_ = !completeParameters_.branchColumnUntilValue_;
+		}
+		if (w >= 2) {
+			if (MasterProblem* pMaster = dynamic_cast<MasterProblem*>(workers[w]))
+				pMaster->getModel()->setSearchStrategy(DepthFirstSearch);
+		}
+	}
+
+	// explore the trees concurrently, each with its own random stream
+	//
+	std::vector<int> seeds = Tools::splitRandomStream(nbWorkers);
+	std::vector<std::exception_ptr> errors(nbWorkers);
+	std::vector<std::thread> threads;
+	for (int w=0; w < nbWorkers; w++) {
+		threads.push_back(std::thread([w, &workers, &params, &errors, &incumbent, &seeds]() {
+			try {
+				Tools::initializeRandomStream(seeds[w]);
+				workers[w]->solve(params[w]);
+			}
+			catch (...) {
+				errors[w] = std::current_exception();
+				incumbent.isSearchOver_ = true;
+			}
+		}));
+	}
+	for (std::thread& thread: threads) thread.join();
+
+	// keep the worker with the best solution: a tree can prove the optimality
+	// of a solution found by another one
+	//
+	int bestWorker = 0;
+	double bestObjVal = LARGE_SCORE;
+	bool isOptimal = false;
+	for (int w=0; w < nbWorkers; w++) {
+		if (workers[w]->getStatus() == OPTIMAL) isOptimal = true;
+		MasterProblem* pMaster = dynamic_cast<MasterProblem*>(workers[w]);
+		if (pMaster && pMaster->getModel()->nbSolutions() > 0
+			&& pMaster->getModel()->getObjective() < bestObjVal) {
+			bestObjVal = pMaster->getModel()->getObjective();
+			bestWorker = w;
+		}
+	}
+	for (int w=0; w < nbWorkers; w++) {
+		if (w != bestWorker) delete workers[w];
+	}
+	pCompleteSolver_ = workers[bestWorker];
+	for (std::exception_ptr& e: errors)
+		if (e) std::rethrow_exception(e);
+
+	if (isOptimal && bestObjVal < LARGE_SCORE) {
+		pCompleteSolver_->setStatus(OPTIMAL);
+	}
+
+	return this->treatResults(pCompleteSolver_);
+}
+
 
 //----------------------------------------------------------------------------
 // After the end of a solution process: retrieve status, solution, etc.
@@ -472,73 +607,177 @@ double DeterministicSolver::solveByConnexPositions() {
 	vector<Scenario*> scenariosPerComponent;
 	scenariosPerComponent = divideScenarioIntoConnexPositions(pScenario_);
 
+	// SOLVE THE COMPONENTS CONCURRENTLY
+	if (options_.nbComponentThreads_ > 1 && scenariosPerComponent.size() > 1) {
+		if (!solveConnexComponentsInParallel(scenariosPerComponent)) {
+			std::cout << "Solution process did not terminate normally" << std::endl;
+			return -1;
+		}
+	}
+
 	// SOLVE THE PROBLEM COMPONENT-WISE
-	vector<DeterministicSolver*> solverPerComponent;
+	else {
+		vector<DeterministicSolver*> solverPerComponent;
+		for (Scenario* pScenario: scenariosPerComponent) {
+			std::cout << "COMPONENT-WISE SCENARIO" << std::endl;
+			std::cout << pScenario->toString() << std::endl;
+
+			// SET THE SOLVER AND SOLVE THE SUBPROBLEM
+			InputPaths inputPaths;
+			solverPerComponent.push_back(new DeterministicSolver(pScenario,inputPaths));
+			solverPerComponent.back()->copyParameters(this);
+			solverPerComponent.back()->setParentDeadline(pDeadline_);
+
+			// set allowed time proportionnally to the number of nurses in each
+			// component
+			double allowedTime = options_.totalTimeLimitSeconds_*(double)pScenario->nbNurses()/(double)pScenario_->nbNurses();
+			// if solving the last component, leave it all the time left
+			if (solverPerComponent.size() == scenariosPerComponent.size()) {
+				allowedTime = std::max(allowedTime,pDeadline_->remaining());
+			}
+			solverPerComponent.back()->setTotalTimeLimit(allowedTime);
+
+			// solve the component
+			solverPerComponent.back()->solve();
+
+			// STORE THE SOLUTION
+			// Be particularly cautious that the nurse indices are not the same in the
+			// initial scenario and in the solvers per component
+			for (int n=0; n<pScenario->nbNurses_; ++n) {
+				int idNurse = pScenario->theNurses_[n].id_;
+				theLiveNurses_[idNurse]->roster_ = solverPerComponent.back()->getSolution()[n];
+			}
+
+			// Consolidate the global state of the solver
+			stats_.add(solverPerComponent.back()->getGlobalStat());
+			Status lastStatus = solverPerComponent.back()->getStatus();
+
+			// in several cases, the new status is the status of the last solver solved
+			if (status_ == UNSOLVED || status_ == OPTIMAL ||
+				lastStatus == INFEASIBLE || lastStatus == TIME_LIMIT || lastStatus == UNSOLVED) {
+				status_ = lastStatus;
+			}
+			// in all other cases status is unchanged
+			else {	}
+
+			// break if the status is not that of a normally finished solution process
+			if (status_ == UNSOLVED || status_ == TIME_LIMIT || status_ == INFEASIBLE) {
+				std::cout << "Solution process did not terminate normally" << std::endl;
+				return -1;
+			}
+
+			// the solver of the component can be deleted at this stage
+			delete solverPerComponent.back();
+			solverPerComponent.back()=0;
+		}
+	}
+
+	// update nurses' states
+	for(int n=0; n<pScenario_->nbNurses_; ++n){
+		solution_.push_back(theLiveNurses_[n]->roster_);
+		theLiveNurses_[n]->buildStates();
+	}
+
+	//  release memory
 	for (Scenario* pScenario: scenariosPerComponent) {
+		if (pScenario->pWeekDemand()) delete pScenario->pWeekDemand();
+		pScenario->setWeekDemand(0);
+	}
+
+	return computeSolutionCost();
+}
+
+bool DeterministicSolver::solveConnexComponentsInParallel(vector<Scenario*>& scenariosPerComponent) {
+
+	int nbComponents = scenariosPerComponent.size();
+
+	// SET THE SOLVERS
+	// The largest components are started first
+	vector<DeterministicSolver*> solverPerComponent;
+	vector<int> componentsOrder;
+	for (int c=0; c < nbComponents; c++) {
+		Scenario* pScenario = scenariosPerComponent[c];
 		std::cout << "COMPONENT-WISE SCENARIO" << std::endl;
 		std::cout << pScenario->toString() << std::endl;
 
-		// SET THE SOLVER AND SOLVE THE SUBPROBLEM
 		InputPaths inputPaths;
 		solverPerComponent.push_back(new DeterministicSolver(pScenario,inputPaths));
 		solverPerComponent.back()->copyParameters(this);
+		solverPerComponent.back()->setParentDeadline(pDeadline_);
+		componentsOrder.push_back(c);
+	}
+	std::stable_sort(componentsOrder.begin(), componentsOrder.end(), [&scenariosPerComponent](int c1, int c2) {
+		return scenariosPerComponent[c1]->nbNurses() > scenariosPerComponent[c2]->nbNurses();
+	});
+
+	// SOLVE THE COMPONENTS
+	// Each thread takes the next component that is not started yet
+	int nbThreads = std::min(options_.nbComponentThreads_, nbComponents);
+	int nbStarted = 0, nbNursesNotStarted = pScenario_->nbNurses();
+	std::mutex startMutex;
+	vector<std::exception_ptr> errors(nbThreads);
+	vector<std::thread> threads;
+	for (int t=0; t < nbThreads; t++) {
+		threads.push_back(std::thread([&, t]() {
+			try {
+				while (true) {
+					DeterministicSolver* pSolver;
+					{
+						std::lock_guard<std::mutex> lock(startMutex);
+						if (nbStarted == nbComponents) return;
+						int c = componentsOrder[nbStarted++];
+						pSolver = solverPerComponent[c];
+						int nbNurses = scenariosPerComponent[c]->nbNurses();
+
+						// set allowed time proportionnally to the number of nurses of the component, knowing
+						// that nbThreads components are solved at the same time
+						double timeLeft = pDeadline_->remaining();
+						double allowedTime = timeLeft;
+						if (nbStarted < nbComponents)
+							allowedTime = std::min(timeLeft, timeLeft*nbThreads*(double)nbNurses/(double)nbNursesNotStarted);
+						nbNursesNotStarted -= nbNurses;
+						pSolver->setTotalTimeLimit(allowedTime);
+					}
+					pSolver->solve();
+				}
+			}
+			catch (...) {
+				errors[t] = std::current_exception();
+			}
+		}));
+	}
+	for (std::thread& thread: threads) thread.join();
+	for (std::exception_ptr& e: errors)
+		if (e) std::rethrow_exception(e);
 
-		// set allowed time proportionnally to the number of nurses in each
-		// component
-		double allowedTime = options_.totalTimeLimitSeconds_*(double)pScenario->nbNurses()/(double)pScenario_->nbNurses();
-		// if solving the last component, leave it all the time left
-		if (solverPerComponent.size() == scenariosPerComponent.size()) {
-			allowedTime = std::max(allowedTime,options_.totalTimeLimitSeconds_-pTimerTotal_->dSinceStart());
-		}
-		solverPerComponent.back()->setTotalTimeLimit(allowedTime);
-
-		// solve the component
-		solverPerComponent.back()->solve();
+	// STORE THE SOLUTIONS IN THE ORDER OF THE COMPONENTS
+	bool isNormal = true;
+	for (int c=0; c < nbComponents; c++) {
+		Scenario* pScenario = scenariosPerComponent[c];
+		DeterministicSolver* pSolver = solverPerComponent[c];
 
-		// STORE THE SOLUTION
 		// Be particularly cautious that the nurse indices are not the same in the
 		// initial scenario and in the solvers per component
 		for (int n=0; n<pScenario->nbNurses_; ++n) {
 			int idNurse = pScenario->theNurses_[n].id_;
-			theLiveNurses_[idNurse]->roster_ = solverPerComponent.back()->getSolution()[n];
+			theLiveNurses_[idNurse]->roster_ = pSolver->getSolution()[n];
 		}
 
 		// Consolidate the global state of the solver
-		stats_.add(solverPerComponent.back()->getGlobalStat());
-		Status lastStatus = solverPerComponent.back()->getStatus();
-
-		// in several cases, the new status is the status of the last solver solved
+		stats_.add(pSolver->getGlobalStat());
+		Status lastStatus = pSolver->getStatus();
 		if (status_ == UNSOLVED || status_ == OPTIMAL ||
 			lastStatus == INFEASIBLE || lastStatus == TIME_LIMIT || lastStatus == UNSOLVED) {
 			status_ = lastStatus;
 		}
-		// in all other cases status is unchanged
-		else {	}
-
-		// break if the status is not that of a normally finished solution process
 		if (status_ == UNSOLVED || status_ == TIME_LIMIT || status_ == INFEASIBLE) {
-			std::cout << "Solution process did not terminate normally" << std::endl;
-			return -1;
+			isNormal = false;
 		}
 
-		// the solver of the component can be deleted at this stage
-		delete solverPerComponent.back();
-		solverPerComponent.back()=0;
+		delete pSolver;
 	}
 
-	// update nurses' states
-	for(int n=0; n<pScenario_->nbNurses_; ++n){
-		solution_.push_back(theLiveNurses_[n]->roster_);
-		theLiveNurses_[n]->buildStates();
-	}
-
-	//  release memory
-	for (Scenario* pScenario: scenariosPerComponent) {
-		if (pScenario->pWeekDemand()) delete pScenario->pWeekDemand();
-		pScenario->setWeekDemand(0);
-	}
-
-	return computeSolutionCost();
+	return isNormal;
 }
 
 //------------------------------------------------------------------------
@@ -607,7 +846,7 @@ double DeterministicSolver::solveWithRollingHorizon() {
 		//
 		double timeSinceStart = pTimerTotal_->dSinceStart();
 		std::cout << "Time spent until then: " << timeSinceStart << " s" << std::endl;
-		if (timeSinceStart > options_.totalTimeLimitSeconds_) {
+		if (pDeadline_->isExpired()) {
 			std::cout << "Stop the rolling horizon: time limit is reached!" << std::endl;
 			break;
 		}
@@ -668,11 +907,15 @@ double DeterministicSolver::solveWithLNS() {
 
 	// set the computational time left for the lns after the initialization
 	double timeSinceStart = pTimerTotal_->dSinceStart();
-	lnsParameters_.maxSolvingTimeSeconds_ = options_.totalTimeLimitSeconds_ - timeSinceStart;
+	lnsParameters_.maxSolvingTimeSeconds_ = pDeadline_->remaining();
 
 	// pLNSSolver_ = setSolverWithInputAlgorithm(pDemand_);
 	// pLNSSolver_->initialize(options_.lnsParameters_,this->solution_);
 
+	if (options_.lnsNbWorkers_ > 1) {
+		return solveWithParallelLNS(nursesSelectionWeights, daysSelectionWeights, repairWeights);
+	}
+
 	// Perform destroy/repair iterations until a given number of iterations
 	// without improvement is reached
 	//
@@ -688,7 +931,7 @@ double DeterministicSolver::solveWithLNS() {
 		DaysSelectionOperator dayOperator = daysSelectionOperators_[dayIndex];
 
 		// apply the destroy operator
-		this->adaptiveDestroy(nurseOperator, dayOperator);
+		this->adaptiveDestroy(nurseOperator, dayOperator, pLNSSolver_);
 
 		// run the repair operator
 		//
@@ -699,10 +942,10 @@ double DeterministicSolver::solveWithLNS() {
 		timeSinceStart = pTimerTotal_->dSinceStart();
 		std::cout << "Time spent until then: " << timeSinceStart << " s" ;
 		std::cout << "(time limit is "<< options_.totalTimeLimitSeconds_ << " s)" << std::endl;
-		if (pLNSSolver_->getStatus()==TIME_LIMIT && timeSinceStart <= options_.totalTimeLimitSeconds_ - 5.0) {
+		if (pLNSSolver_->getStatus()==TIME_LIMIT && pDeadline_->remaining() >= 5.0) {
 			Tools::throwError("Error with the timers in LNS!");
 		}
-		if (pLNSSolver_->getStatus()==TIME_LIMIT || timeSinceStart > options_.totalTimeLimitSeconds_) {
+		if (pLNSSolver_->getStatus()==TIME_LIMIT || pDeadline_->isExpired()) {
 			std::cout << "Stop the lns: time limit is reached" << std::endl;
 			break;
 		}
@@ -727,7 +970,7 @@ double DeterministicSolver::solveWithLNS() {
 			nbItWithoutImprovement = 0;
 			lnsParameters_.setOptimalityLevel(TWO_DIVES);
 			nursesSelectionWeights[nurseIndex] = nursesSelectionWeights[nurseIndex]+1.0;
-			daysSelectionWeights[nurseIndex] = daysSelectionWeights[nurseIndex]+1.0;
+			daysSelectionWeights[dayIndex] = daysSelectionWeights[dayIndex]+1.0;
 
 			// update weights of the repair operators
 			double timeIteration = pTimerTotal_->dSinceInit()-timeSinceStart;
@@ -771,6 +1014,146 @@ double DeterministicSolver::solveWithLNS() {
 }
 
 
+// Perform the LNS with several concurrent destroy/repair iterations
+//
+double DeterministicSolver::solveWithParallelLNS(std::vector<double>& nursesSelectionWeights,
+	std::vector<double>& daysSelectionWeights, std::vector<double>& repairWeights) {
+
+	int nbWorkers = options_.lnsNbWorkers_;
+
+	// The first worker uses the solver that already contains the initial solution
+	//
+	lnsWorkers_.assign(nbWorkers, 0);
+	lnsWorkers_[0] = pLNSSolver_;
+	for (int w=1; w < nbWorkers; w++) {
+		lnsWorkers_[w] = setSolverWithInputAlgorithm(pDemand_);
+		lnsWorkers_[w]->LNSInitialize(lnsParameters_, solution_);
+	}
+
+	int nbItWithoutImprovement=0;
+	double bestObjVal=this->computeSolutionCost();
+	while (true) {
+
+		// draw the destroy/repair operators and apply the destroy operator of each worker
+		// (all the random draws are done here to keep them in one thread)
+		//
+		std::vector<int> nurseIndices(nbWorkers), dayIndices(nbWorkers), repairIndices(nbWorkers);
+		for (int w=0; w < nbWorkers; w++) {
+			nurseIndices[w] = Tools::drawRandomWithWeights(nursesSelectionWeights);
+			dayIndices[w] = Tools::drawRandomWithWeights(daysSelectionWeights);
+			repairIndices[w] = Tools::drawRandomWithWeights(repairWeights);
+			this->adaptiveDestroy(nursesSelectionOperators_[nurseIndices[w]], daysSelectionOperators_[dayIndices[w]], lnsWorkers_[w]);
+		}
+
+		// run the repair operators concurrently, each with its own random stream
+		//
+		double timeSinceStart = pTimerTotal_->dSinceStart();
+		std::vector<int> seeds = Tools::splitRandomStream(nbWorkers);
+		std::vector<double> objValues(nbWorkers, DBL_MAX);
+		std::vector<std::exception_ptr> errors(nbWorkers);
+		std::vector<std::thread> threads;
+		for (int w=0; w < nbWorkers; w++) {
+			threads.push_back(std::thread([this, w, &objValues, &errors, &seeds]() {
+				try {
+					Tools::initializeRandomStream(seeds[w]);
+					objValues[w] = lnsWorkers_[w]->LNSSolve(lnsParameters_);
+				}
+				catch (...) {
+					errors[w] = std::current_exception();
+				}
+			}));
+		}
+		for (std::thread& thread: threads) thread.join();
+		for (std::exception_ptr& e: errors)
+			if (e) std::rethrow_exception(e);
+
+		// stop lns if runtime is exceeded
+		//
+		double timeIteration = pTimerTotal_->dSinceStart()-timeSinceStart;
+		timeSinceStart = pTimerTotal_->dSinceStart();
+		std::cout << "Time spent until then: " << timeSinceStart << " s" ;
+		std::cout << "(time limit is "<< options_.totalTimeLimitSeconds_ << " s)" << std::endl;
+		bool isTimeLimit = pDeadline_->isExpired();
+		for (Solver* pSolver: lnsWorkers_)
+			if (pSolver->getStatus()==TIME_LIMIT) isTimeLimit = true;
+		if (isTimeLimit) {
+			std::cout << "Stop the lns: time limit is reached" << std::endl;
+			break;
+		}
+
+		// get the best worker and aggregate the weights of the workers that improved the solution
+		//
+		int bestWorker = 0;
+		for (int w=0; w < nbWorkers; w++) {
+			if (objValues[w] < objValues[bestWorker]) bestWorker = w;
+			if (objValues[w] < bestObjVal-EPSILON) {
+				stats_.lnsNbIterationsWithImprovement_++;
+				nursesSelectionWeights[nurseIndices[w]] += 1.0;
+				daysSelectionWeights[dayIndices[w]] += 1.0;
+				repairWeights[repairIndices[w]] += 10.0/timeIteration;
+				stats_.nbImprovementsWithNursesSelection_[nurseIndices[w]]++;
+				stats_.nbImprovementsWithDaysSelection_[dayIndices[w]]++;
+				stats_.nbImprovementsWithRepair_[repairIndices[w]]++;
+			}
+		}
+
+		// unfix every nurse and/or days for next iteration
+		//
+		std::vector<bool> isUnfixNurse(pScenario_->nbNurses_,true);
+		std::vector<bool> isUnfixDay(getNbDays(),true);
+		for (Solver* pSolver: lnsWorkers_) {
+			pSolver->unfixNurses(isUnfixNurse);
+			pSolver->unfixDays(isUnfixDay);
+		}
+		stats_.lnsNbIterations_ += nbWorkers;
+
+		// update the shared best solution
+		//
+		if (objValues[bestWorker] < bestObjVal-EPSILON) {
+			stats_.lnsImprovementValueTotal_+=bestObjVal-objValues[bestWorker];
+			bestObjVal = objValues[bestWorker];
+			nbItWithoutImprovement = 0;
+			lnsParameters_.setOptimalityLevel(TWO_DIVES);
+
+			pLNSSolver_ = lnsWorkers_[bestWorker];
+			solution_ = pLNSSolver_->getSolution();
+			status_ = pLNSSolver_->getStatus();
+			if (lnsParameters_.printIntermediarySol_) {
+				pLNSSolver_->printCurrentSol();
+			}
+
+			// the other workers restart from the new best solution
+			for (int w=0; w < nbWorkers; w++) {
+				if (w == bestWorker) continue;
+				if (lnsWorkers_[w] != pCompleteSolver_ && lnsWorkers_[w] != pRollingSolver_)
+					delete lnsWorkers_[w];
+				lnsWorkers_[w] = setSolverWithInputAlgorithm(pDemand_);
+				lnsWorkers_[w]->LNSInitialize(lnsParameters_, solution_);
+			}
+		}
+		else {
+			nbItWithoutImprovement++;
+
+			if (nbItWithoutImprovement > std::min(30,options_.lnsMaxItWithoutImprovement_/2) ) {
+				lnsParameters_.setOptimalityLevel(OPTIMALITY);
+			}
+			else if (nbItWithoutImprovement > std::min(10,options_.lnsMaxItWithoutImprovement_/4) ) {
+				lnsParameters_.setOptimalityLevel(REPEATED_DIVES);
+			}
+		}
+
+		std::cout << "**********************************************" << std::endl
+		          << "LNS iteration: " << stats_.lnsNbIterations_
+		          << "\t" << "Best solution: " << bestObjVal << std::endl
+		          << "**********************************************" << std::endl;
+	}
+
+	std::cout << "END OF LNS" << std::endl << std::endl;
+
+	return treatResults(pLNSSolver_);
+}
+
+
 // Prepare data structures for LNS
 //
 void DeterministicSolver::initializeLNS() {
@@ -811,7 +1194,7 @@ void DeterministicSolver::initializeLNS() {
 
 // Application of the destroy operator
 //
-void DeterministicSolver::adaptiveDestroy(NursesSelectionOperator nurseOp, DaysSelectionOperator dayOp) {
+void DeterministicSolver::adaptiveDestroy(NursesSelectionOperator nurseOp, DaysSelectionOperator dayOp, Solver* pSolver) {
 	// apply the destroy operator
 	std::vector<bool> isFixNurse(pScenario_->nbNurses_,true);
 	std::vector<bool> isFixDay(pScenario_->nbDays(),true);
@@ -865,7 +1248,7 @@ void DeterministicSolver::adaptiveDestroy(NursesSelectionOperator nurseOp, DaysS
 		}
 	}
 	// Fix the nurses that are not destroyed
-	pLNSSolver_->fixNurses(isFixNurse);
+	pSolver->fixNurses(isFixNurse);
 
 	// GENERATE THE DAYS THAT WILL BE DESTROYED AND FIX THE OTHERS
 	// fix no day if the number of days in the scenario is small
@@ -880,7 +1263,7 @@ void DeterministicSolver::adaptiveDestroy(NursesSelectionOperator nurseOp, DaysS
 		for (int day=0; day <nbDaysDestroy; day++) {
 			isFixDay[firstDay+day] = false;
 		}
-		pLNSSolver_->fixDays(isFixDay);
+		pSolver->fixDays(isFixDay);
 	}
 
 	// DBG
@@ -29,6 +29,13 @@ public:
 	// True -> decompose the process to treat nurses with non connex positions separately
 	bool divideIntoConnexPositions_ = true;
 
+	// Number of connex components solved concurrently (each by its own solver in its own thread)
+	int nbComponentThreads_ = 1;
+
+	// Number of branch and price trees that solve the complete horizon concurrently,
+	// each with its own LP and pricer and its own diving strategy, sharing their incumbent
+	int nbTreeWorkers_ = 1;
+
 	// True -> solves the problem with a receeding horizon
 	// False -> solves the whole horizon directly
 	bool withRollingHorizon_ = false;
@@ -58,6 +65,9 @@ public:
 	int lnsNbNursesDestroyOverFourWeeks_ = 10;
 	int lnsNbNursesDestroyOverAllWeeks_ = 5;
 
+	// Number of destroy/repair iterations run concurrently in the LNS, each by its own repair solver
+	int lnsNbWorkers_ = 1;
+
 	// parameters of column generation
 	bool isStabilization_ = false;
 	bool isStabUpdateCost_ = false;
@@ -164,10 +174,14 @@ public:
 	//
 	void updateInitialStats(MasterProblem* pMaster);
 	void updateImproveStats(MasterProblem* pMaster);
+	void updateTimeStats();
 
 protected:
 	GlobalStats stats_;
 
+	// CPU time of the process at the beginning of the solution
+	double cpuTimeAtStart_ = 0.0;
+
 
 	//----------------------------------------------------------------------------
 	//
@@ -186,6 +200,12 @@ public:
 
 protected:
 
+	// Solve the components concurrently with nbComponentThreads_ threads sharing the time limit:
+	// when a thread starts a new component, it gets a share of the time left proportional to its
+	// number of nurses, so the time saved on the components solved early goes to the next ones.
+	// Return false if one of the solution processes did not terminate normally
+	bool solveConnexComponentsInParallel(vector<Scenario*>& scenariosPerComponent);
+
 	// Ready the solver for the solution process
 	void init();
 
@@ -205,6 +225,13 @@ public:
 	//
 	double solveCompleteHorizon();
 
+protected:
+	// Solve the complete horizon with nbTreeWorkers_ trees explored concurrently.
+	// The trees share their incumbent to fathom their nodes and they all stop
+	// as soon as one of them has completed its search
+	//
+	double solveCompleteHorizonInParallel();
+
 private:
 	// Solver that will be called to solve each sampling period in the rolling
 	// horizon
@@ -264,9 +291,16 @@ protected:
 	//
 	void initializeLNS();
 
-	// Application of the destroy operator
+	// LNS where lnsNbWorkers_ destroy/repair iterations are run concurrently at each round.
+	// The workers share the best solution found so far: a worker whose solution is worse
+	// is given a new repair solver that starts from the best solution at the end of the round
+	//
+	double solveWithParallelLNS(std::vector<double>& nursesSelectionWeights,
+		std::vector<double>& daysSelectionWeights, std::vector<double>& repairWeights);
+
+	// Application of the destroy operator to the input solver
 	//
-	void adaptiveDestroy(NursesSelectionOperator nurseOp, DaysSelectionOperator dayOp);
+	void adaptiveDestroy(NursesSelectionOperator nurseOp, DaysSelectionOperator dayOp, Solver* pSolver);
 
 	// Initialize the organized vectors of live nurses
 	//
@@ -277,6 +311,10 @@ protected:
 	//
 	Solver* pLNSSolver_;
 
+	// Repair solvers of the parallel LNS (the first one is initially pLNSSolver_)
+	//
+	std::vector<Solver*> lnsWorkers_;
+
 	// Parameters of the LNS
 	//
 	SolverParam lnsParameters_;
@@ -7,6 +7,7 @@
 //
 
 #include <exception>
+#include <future>
 
 #include "MyTools.h"
 #include "ReadWrite.h"
@@ -117,21 +118,43 @@ pair<double, int> testMultipleWeeksStochastic(string dataDir, string instanceNam
 	vector<int> seeds;
 
 	for (int week = 0; week < nbWeeks; week++) {
-	   if(week==0 and seed != -1)
-	      seeds.push_back(seed);
+	   // the seed of each week is derived from the seed of the first one, so that
+	   // the sequence does not depend on the other users of std::rand
+	   if(week==0)
+	      seeds.push_back(seed != -1 ? seed : std::rand());
 	   else
-	      seeds.push_back(std::rand());
+	      seeds.push_back(Tools::getStreamSeed(seeds[0], week));
 	   std::srand(seeds[week]);
+	   Tools::initializeRandomGenerator(seeds[week]);
 
 		demandHistory.push_back(new Demand (*(pScen->pWeekDemand())) );
 
 		StochasticSolver* pSolver = new StochasticSolver(pScen, stochasticSolverOptions, demandHistory, currentCost);
 
+		// read the demand and preferences of next week while this week is solved:
+		// they only depend on the scenario, the initial states are handed over
+		// once the week is solved
+		std::future<pair<Demand*, Preferences*>> nextWeek;
+		if (week < nbWeeks-1) {
+			string weekPath = inputPaths.week(week+1);
+			nextWeek = std::async(std::launch::async, [weekPath, pScen]() {
+				Demand* pDemand(0);
+				Preferences* pPref(0);
+				ReadWrite::readWeek(weekPath, pScen, &pDemand, &pPref);
+				return pair<Demand*, Preferences*>(pDemand, pPref);
+			});
+		}
+
 		currentCost += pSolver->solve();
 		nbSched += pSolver->getNbSchedules();
 		printf( "Current cost = %.2f \n", currentCost);
 		solutionStatus = pSolver->getStatus();
 		if (solutionStatus == INFEASIBLE) {
+			if (nextWeek.valid()) {
+				pair<Demand*, Preferences*> next = nextWeek.get();
+				delete next.first;
+				delete next.second;
+			}
 			delete pSolver;
 			break;
 		}
@@ -153,12 +176,10 @@ pair<double, int> testMultipleWeeksStochastic(string dataDir, string instanceNam
 		// prepare the scenario for next week if we did not reach the last week yet
 		if (week < nbWeeks-1) {
 
-			// Initialize demand and preferences
-			Demand* pDemand(0);
-			Preferences* pPref(0);
-
-			// Read the demand and preferences and link them with the scenario
-			ReadWrite::readWeek(inputPaths.week(week+1), pScen, &pDemand, &pPref);
+			// Get the demand and preferences read during the solution of the week
+			pair<Demand*, Preferences*> next = nextWeek.get();
+			Demand* pDemand = next.first;
+			Preferences* pPref = next.second;
 
 			// read the initial state of the new week from the last state of the
 			// last week
@@ -295,6 +316,7 @@ int main(int argc, char** argv)
     }
 
     srand(randSeed);
+    Tools::initializeRandomGenerator(randSeed);
 
     // Solve the week
     solveOneWeek(scenarioFile, weekDataFile, initialHistoryFile, customInputFile, solutionFile, timeout);
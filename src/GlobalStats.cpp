@@ -32,6 +32,7 @@ std::string GlobalStats::toString() {
 	statStream << timeGenSubProblems_ << "\t";
 	statStream << itGenColInitial_ << "\t" << itGenColImprove_ << "\t";
 	statStream << nodesBBInitial_ << "\t" << nodesBBImprove_ << "\t";
+	statStream << timeTotal_ << "\t" << cpuTimeTotal_ << "\t";
 
 	return statStream.str();
 }
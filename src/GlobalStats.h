@@ -48,9 +48,11 @@ public:
 	double rootLB_ = 0.0;
 	double bestLB_ = 0.0;
 
-	// global runtimes
+	// global runtimes: the wall-clock time and the CPU time of the process of
+	// the whole solution (the CPU time is larger when several threads are used)
 	//
 	double timeTotal_=0.0;
+	double cpuTimeTotal_=0.0;
 	double timeInitialSol_=0.0;
 	double timeImproveSol_=0.0;
 
@@ -21,8 +21,11 @@
 #include <sys/types.h>
 
 //initialize the counter of objects
-unsigned int MyObject::s_count = 0;
-unsigned int Rotation::s_count = 0;
+std::atomic<unsigned int> MyObject::s_count(0);
+std::atomic<unsigned int> Rotation::s_count(0);
+
+//lock of the metrics files shared by the modelers
+std::mutex Modeler::s_metricsMutex;
 
 
 
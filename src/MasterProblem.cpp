@@ -480,6 +480,9 @@ double MasterProblem::solve(vector<Roster> solution, bool rebuild){
 }
 
 void MasterProblem::solveWithCatch(){
+	// the time limit of this solution starts now and ends with the deadline of the caller
+	setParentDeadline(pModel_->getParameters().pDeadline_);
+	startDeadline(pModel_->getParameters().maxSolvingTimeSeconds_);
 	pModel_->solve();
 }
 
@@ -19,50 +19,80 @@
 #include "Modeler.h"
 #include "OsiSolverInterface.hpp"
 
+#include <atomic>
+
 //-----------------------------------------------------------------------------
 //
-//  S t r u c t   R o t a t i o n
+//  S t r u c t   N u r s e D u a l R o w s
 //
-//  A rotation is a set of shifts for a set of consecutive days.
-//  It has a cost and a dual cost (tbd).
+//  Indices of the rows of the master problem whose dual values make up the
+//  dual costs of the subproblem of a nurse. They are computed once, when the
+//  master is built, and used to read the dual solution without any lookup.
 //
 //-----------------------------------------------------------------------------
-enum CostType {TOTAL_COST, CONS_SHIFTS_COST, CONS_WORKED_DAYS_COST, COMPLETE_WEEKEND_COST, PREFERENCE_COST, INIT_REST_COST};
+struct NurseDualRows{
+	// Rows of the coverage constraints of the position of the nurse
+	// Indexed by : day*nbWorkShifts_ + shift !! 0 = shift 1 !!
+	vector<int> workRows_;
+	int nbWorkShifts_ = 0;
+
+	// Rows of the min and max constraints on the number of worked days
+	// (for the nurse, on average for the nurse and on average for the contract)
+	vector<int> minWorkedDaysRows_;
+	vector<int> maxWorkedDaysRows_;
+
+	// Rows of the flow constraints, indexed by day.
+	// The dual cost of ending a rotation on day k is endWorkSigns_[k]*dual(endWorkRows_[k])
+	vector<int> startWorkRows_;
+	vector<int> endWorkRows_;
+	vector<double> endWorkSigns_;
+
+	// Rows of the constraints on the number of worked weekends
+	vector<int> workedWeekendRows_;
+};
 
+//-----------------------------------------------------------------------------
+//
+//  S t r u c t   D u a l C o s t s
+//
+//  Dual costs of the subproblem of a nurse. It is a read-only view on the dual
+//  solution of the modeler (nothing is copied), so it is only valid until the
+//  next LP solution, and it can be shared by concurrent pricing threads.
+//
+//-----------------------------------------------------------------------------
 struct DualCosts{
 public:
 
-	DualCosts(vector< vector<double> > & workCosts, vector<double> & startWorkCosts, vector<double> & endWorkCosts, double workedWeekendCost, bool doNotCopy = true):
-	workCosts_(workCosts), startWorkCosts_(startWorkCosts), endWorkCosts_(endWorkCosts), workedWeekendCost_(workedWeekendCost) {
-
-		if(!doNotCopy){
-			workCosts_.clear();
-			workCosts_ = Tools::appendVectors(workCosts_, workCosts);
-			startWorkCosts_.clear();
-			startWorkCosts_ = Tools::appendVectors(startWorkCosts_, startWorkCosts);
-			endWorkCosts_.clear();
-			endWorkCosts_ = Tools::appendVectors(endWorkCosts_, endWorkCosts);
-		}
+	DualCosts(const double* duals, const NurseDualRows& rows):
+	duals_(duals), rows_(rows), workedDaysCost_(0), workedWeekendCost_(0) {
+		double minWorkedDaysCost = 0, maxWorkedDaysCost = 0;
+		for(int row: rows_.minWorkedDaysRows_) minWorkedDaysCost += duals_[row];
+		for(int row: rows_.maxWorkedDaysRows_) maxWorkedDaysCost += duals_[row];
+		workedDaysCost_ = minWorkedDaysCost;
+		workedDaysCost_ += maxWorkedDaysCost;
+		for(int row: rows_.workedWeekendRows_) workedWeekendCost_ += duals_[row];
 	}
 
 	// GETTERS
 	//
-	inline double dayShiftWorkCost(int day, int shift){return (workCosts_[day][shift]);}
-	inline double startWorkCost(int day){return (startWorkCosts_[day]);}
-	inline double endWorkCost(int day){return (endWorkCosts_[day]);}
+	inline double dayShiftWorkCost(int day, int shift){
+		return workedDaysCost_ + duals_[rows_.workRows_[day*rows_.nbWorkShifts_+shift]];
+	}
+	inline double startWorkCost(int day){return duals_[rows_.startWorkRows_[day]];}
+	inline double endWorkCost(int day){return rows_.endWorkSigns_[day] * duals_[rows_.endWorkRows_[day]];}
 	inline double workedWeekendCost(){return workedWeekendCost_;}
 
 
 protected:
 
-	// Indexed by : (day, shift) !! 0 = shift 1 !!
-	vector< vector<double> > & workCosts_;
+	// Dual values of the rows of the master, indexed by the index of the constraints
+	const double* duals_;
 
-	// Indexed by : day
-	vector<double> & startWorkCosts_;
+	// Rows of the nurse
+	const NurseDualRows& rows_;
 
-	// Indexed by : day
-	vector<double> & endWorkCosts_;
+	// Dual cost paid by every worked day (min/max worked days constraints)
+	double workedDaysCost_;
 
 	// Reduced cost of the weekends
 	double workedWeekendCost_;
@@ -70,44 +100,110 @@ protected:
 };
 
 
+//-----------------------------------------------------------------------------
+//
+//  S t r u c t   R o t a t i o n S h i f t s
+//
+//  Shifts of the consecutive days of a rotation, with one byte per day.
+//  The shifts of the usual rotations fit in an inline array, so building or
+//  copying a rotation does not allocate any memory: only the long rotations
+//  (e.g., the artificial ones that span the horizon) use the heap.
+//  Iterating gives the pairs (day, shift) in increasing order of the days.
+//
+//-----------------------------------------------------------------------------
+struct RotationShifts{
+public:
+	RotationShifts(int firstDay = 0): firstDay_(firstDay), length_(0) {}
+
+	// the days of the map must be consecutive
+	RotationShifts(const map<int,int>& shifts): firstDay_(shifts.empty() ? 0 : shifts.begin()->first), length_(0) {
+		for(const pair<const int,int>& p: shifts){
+			if(p.first != firstDay_+length_)
+				Tools::throwError("RotationShifts: the days of a rotation must be consecutive.");
+			push_back(p.second);
+		}
+	}
+
+	// add the shift of the day that follows the last day
+	inline void push_back(int shift){
+		if(length_ < INLINE_DAYS) inline_[length_] = (signed char) shift;
+		else heap_.push_back((signed char) shift);
+		++length_;
+	}
+
+	// shift of a day (0 if the day is not in the rotation)
+	inline int operator[](int day) const {
+		int l = day - firstDay_;
+		if(l < 0 || l >= length_) return 0;
+		return (l < INLINE_DAYS) ? inline_[l] : heap_[l-INLINE_DAYS];
+	}
+
+	inline int size() const {return length_;}
+	inline bool empty() const {return length_ == 0;}
+
+	struct const_iterator{
+		const_iterator(const RotationShifts* pShifts, int day): pShifts_(pShifts), day_(day) {}
+		inline pair<int,int> operator*() const {return pair<int,int>(day_, (*pShifts_)[day_]);}
+		inline const_iterator& operator++() {++day_; return *this;}
+		inline bool operator!=(const const_iterator& it) const {return day_ != it.day_;}
+		const RotationShifts* pShifts_;
+		int day_;
+	};
+	inline const_iterator begin() const {return const_iterator(this, firstDay_);}
+	inline const_iterator end() const {return const_iterator(this, firstDay_+length_);}
+
+protected:
+	static const int INLINE_DAYS = 16;
+
+	int firstDay_;
+	int length_;
+	signed char inline_[INLINE_DAYS];
+	vector<signed char> heap_;
+};
+
+//-----------------------------------------------------------------------------
+//
+//  S t r u c t   R o t a t i o n
+//
+//  A rotation is a set of shifts for a set of consecutive days.
+//  It has a cost and a dual cost (tbd).
+//
+//-----------------------------------------------------------------------------
+enum CostType {TOTAL_COST, CONS_SHIFTS_COST, CONS_WORKED_DAYS_COST, COMPLETE_WEEKEND_COST, PREFERENCE_COST, INIT_REST_COST};
+
 struct Rotation {
 
 	// Specific constructors and destructors
 	//
-	Rotation(map<int,int> shifts, int nurseId = -1, double cost = DBL_MAX, double dualCost = DBL_MAX) :
-	shifts_(shifts), nurseId_(nurseId), cost_(cost),id_(s_count),
+	Rotation(const map<int,int>& shifts, int nurseId = -1, double cost = DBL_MAX, double dualCost = DBL_MAX) :
+	id_(s_count++), nurseId_(nurseId), cost_(cost),
 	consShiftsCost_(0), consDaysWorkedCost_(0), completeWeekendCost_(0), preferenceCost_(0), initRestCost_(0),
-	dualCost_(dualCost), length_(shifts.size())
+	dualCost_(dualCost), shifts_(shifts), length_(shifts.size())
 	{
-		++s_count;
-		firstDay_ = 999;
-		for(map<int,int>::iterator itS = shifts.begin(); itS != shifts.end(); ++itS)
-		if(itS->first < firstDay_) firstDay_ = itS->first;
+		firstDay_ = shifts.empty() ? 999 : shifts.begin()->first;
 	};
 
-	Rotation(int firstDay, vector<int> shiftSuccession, int nurseId = -1, double cost = DBL_MAX, double dualCost = DBL_MAX) :
-					id_(s_count),nurseId_(nurseId), cost_(cost),
+	Rotation(int firstDay, const vector<int>& shiftSuccession, int nurseId = -1, double cost = DBL_MAX, double dualCost = DBL_MAX) :
+					id_(s_count++),nurseId_(nurseId), cost_(cost),
 	consShiftsCost_(0), consDaysWorkedCost_(0), completeWeekendCost_(0), preferenceCost_(0), initRestCost_(0),
-	dualCost_(dualCost), firstDay_(firstDay), length_(shiftSuccession.size())
+	dualCost_(dualCost), shifts_(firstDay), firstDay_(firstDay), length_(shiftSuccession.size())
 	{
-		++s_count;
-		for(int k=0; k<length_; k++) shifts_.insert(pair<int,int>( (firstDay+k) , shiftSuccession[k] ));
+		for(int k=0; k<length_; k++) shifts_.push_back(shiftSuccession[k]);
 	}
 
-	Rotation(vector<double> compactPattern) :
-					id_(s_count),nurseId_((int)compactPattern[0]), cost_(DBL_MAX),
+	Rotation(const vector<double>& compactPattern) :
+					id_(s_count++),nurseId_((int)compactPattern[0]), cost_(DBL_MAX),
 	consShiftsCost_(0), consDaysWorkedCost_(0), completeWeekendCost_(0), preferenceCost_(0), initRestCost_(0),
-	dualCost_(DBL_MAX), firstDay_((int)compactPattern[1]), length_(compactPattern.size()-2)
+	dualCost_(DBL_MAX), shifts_((int)compactPattern[1]), firstDay_((int)compactPattern[1]), length_(compactPattern.size()-2)
 	{
-		++s_count;
-		for(int k=0; k<length_; k++) shifts_.insert(pair<int,int>( (firstDay_+k) , (int)compactPattern[k+2] ));
+		for(int k=0; k<length_; k++) shifts_.push_back((int)compactPattern[k+2]);
 	}
 
 	Rotation(Rotation& rotation, int nurseId) :
 					id_(rotation.id_), nurseId_(nurseId), cost_(rotation.cost_),
 	consShiftsCost_(rotation.consShiftsCost_), consDaysWorkedCost_(rotation.consDaysWorkedCost_),
 	completeWeekendCost_(rotation.completeWeekendCost_), preferenceCost_(rotation.preferenceCost_), initRestCost_(rotation.initRestCost_),
-	dualCost_(rotation.dualCost_), firstDay_(rotation.firstDay_), length_(rotation.length_), shifts_(rotation.shifts_)
+	dualCost_(rotation.dualCost_), shifts_(rotation.shifts_), firstDay_(rotation.firstDay_), length_(rotation.length_)
 	{
 		if(rotation.nurseId_ != nurseId_){
 			cost_ = DBL_MAX;
@@ -115,11 +211,9 @@ struct Rotation {
 		}
 	}
 
-	~Rotation(){}
-
-	//count rotations
+	//count rotations (the subproblems may create rotations concurrently)
 	//
-	static unsigned int s_count;
+	static std::atomic<unsigned int> s_count;
 
 	//Id of the rotation
 	//
@@ -140,7 +234,7 @@ struct Rotation {
 
 	// Shifts to be performed
 	//
-	map<int,int> shifts_;
+	RotationShifts shifts_;
 
 	// First worked day
 	//
@@ -157,6 +251,7 @@ struct Rotation {
 	//compact the rotation in a vector
 	const vector<double> getCompactPattern(){
 		vector<double> compact;
+		compact.reserve(length_+2);
 		compact.push_back(nurseId_);
 		compact.push_back(firstDay_);
 		for(pair<int,int> p: shifts_) compact.push_back(p.second);
@@ -178,8 +273,8 @@ struct Rotation {
 		rep << "#   | ROTATION: N=" << nurseId_ << "  cost=" << cost_ << "  dualCost=" << dualCost_ << "  firstDay=" << firstDay_ << "  length=" << length_ << std::endl;
 		rep << "#               |";
 		vector<int> allTasks (nbDays);
-		for(map<int,int>::iterator itTask = shifts_.begin(); itTask != shifts_.end(); ++itTask)
-		allTasks[itTask->first] = itTask->second;
+		for(pair<int,int> task: shifts_)
+		allTasks[task.first] = task.second;
 		for(int i=0; i<allTasks.size(); i++){
 			if(allTasks[i] < 1) rep << " |";
 			else rep << allTasks[i] << "|";
@@ -316,6 +411,11 @@ public:
 	// It is a priori the same as a regular, but it might be modified if needed
 	double LNSSolve(SolverParam parameters);
 
+	// Load the input solution as the current solution of LNSSolve
+	void LNSInitialize(SolverParam parameters, vector<Roster> solution) {
+		initialize(parameters, solution);
+	}
+
 	//---------------------------------------------------------------------------
 	//
 	// Methods required to implement stabilization in the column generation
@@ -20,6 +20,9 @@
 #include <string>
 #include <cmath>
 #include <typeinfo>
+#include <mutex>
+#include <atomic>
+#include <unordered_set>
 #include "Solver.h"
 
 #include "MyTools.h"
@@ -41,28 +44,57 @@ enum SearchStrategy { BestFirstSearch, BreadthFirstSearch, DepthFirstSearch, Hig
 /*
  * My Modeling objects
  * If the object is added to the vector objects_ of the Modeler, the modeler will also delete it at the end.
+ *
+ * The names are not copied in each object: a name of the form prefix_number (e.g., rotation_N3_1234) is
+ * stored as a pointer to the interned prefix and the number, and the other names are interned entirely.
+ * Hence, creating or copying an object does not allocate any memory once its prefix is known, and the name
+ * is formatted only when it is written (getName()).
  */
 struct MyObject {
-	MyObject(const char* name):id_(s_count) {
-		++s_count;
-		char* name2 = new char[255];
-		strncpy(name2, name, 255);
-		name_ = name2;
-	}
-	MyObject(const MyObject& myObject):id_(myObject.id_) {
-		char* name2 = new char[255];
-		strncpy(name2, myObject.name_, 255);
-		name_ = name2;
-	}
-	virtual ~MyObject(){ delete[] name_; }
-	//count object
-	static unsigned int s_count;
+	MyObject(const char* name):id_(s_count++), nameSuffix_(-1) {
+		// split the name if it ends with _number (without leading zero, so that it is formatted back identically)
+		const char* end = name + strlen(name);
+		const char* digits = end;
+		while(digits > name && isdigit(*(digits-1))) --digits;
+		int nbDigits = end-digits;
+		if(digits > name && *(digits-1) == '_' && nbDigits > 0 && nbDigits < 18 && (*digits != '0' || nbDigits == 1)){
+			namePrefix_ = internName(name, digits-1-name);
+			nameSuffix_ = atoll(digits);
+		}
+		else
+			namePrefix_ = internName(name, end-name);
+	}
+	MyObject(const MyObject& myObject):id_(myObject.id_), namePrefix_(myObject.namePrefix_), nameSuffix_(myObject.nameSuffix_) { }
+	virtual ~MyObject(){ }
+	//count object (the models are built concurrently by several threads)
+	static std::atomic<unsigned int> s_count;
 	//for the map rotations_
 	int operator < (const MyObject& m) const { return this->id_ < m.id_; }
 
-	const char* name_;
+	// format the name of the object
+	string getName() const {
+		if(nameSuffix_ < 0) return namePrefix_;
+		std::stringstream name;
+		name << namePrefix_ << "_" << nameSuffix_;
+		return name.str();
+	}
+
+	// return a pointer to the unique copy of the first length characters of name, shared by all the objects
+	// (the names are never released, but there are only a few distinct ones).
+	// The key is built in a buffer of the thread, so that nothing is allocated when the name is known.
+	static const char* internName(const char* name, size_t length){
+		static std::mutex s_namesMutex;
+		static std::unordered_set<string> s_names;
+		static thread_local string s_key;
+		s_key.assign(name, length);
+		std::lock_guard<std::mutex> lock(s_namesMutex);
+		return s_names.insert(s_key).first->c_str();
+	}
+
 private:
 	const unsigned int id_;
+	const char* namePrefix_;
+	long long nameSuffix_;
 };
 
 static const vector<double> DEFAULT_PATTERN;
@@ -152,7 +184,7 @@ struct MyCons: public MyObject{
 	{ }
 
 	MyCons(const MyCons& cons) :
-		MyObject(cons.name_), lhs_(cons.lhs_), index_(cons.index_), rhs_(cons.rhs_)
+		MyObject(cons), lhs_(cons.lhs_), index_(cons.index_), rhs_(cons.rhs_)
 	{ }
 
 	virtual ~MyCons(){ }
@@ -195,6 +227,11 @@ struct MyPricer{
 	// set pricer parameters
 	virtual void initPricerParameters(SolverParam parameters) {}
 
+	// a column has been removed from the LP, or all of them (a new solve starts):
+	// the pricer may store them to price them again later
+	virtual void recycleColumn(MyVar* var) {}
+	virtual void recycleAllColumns() {}
+
 	   // METHODS - Forbidden shifts, nurses, starting days, etc.
    //
    // !!! WARNING !!! : SOME METHODS ARE NOT YET IMPLEMENTED IN THE SUBPROBLEM (ALTHOUGH THE NECESSARY STRUCTURES MAY
@@ -640,7 +677,7 @@ struct MyTree {
 		--nb_nodes_since_dive_;
 	}
 
-	virtual void addForbiddenShifts(LiveNurse* pNurse, set<pair<int,int> >& forbidenShifts) { return; }
+	virtual void addForbiddenShifts(LiveNurse* pNurse, Tools::BitMatrix& forbidenShifts) { return; }
 
 	/*
 	 * Stats
@@ -691,6 +728,7 @@ public:
 		for(MyObject* object: objects_)
 			delete object;
 		objects_.clear();
+		if(pMetricsStream_) delete pMetricsStream_;
 	}
 
 	//solve the model
@@ -719,7 +757,7 @@ public:
 		return 1;
 	}
 
-	virtual void addForbiddenShifts(LiveNurse* pNurse, set<pair<int,int> >& forbidenShifts) {
+	virtual void addForbiddenShifts(LiveNurse* pNurse, Tools::BitMatrix& forbidenShifts) {
 		pTree_->addForbiddenShifts(pNurse, forbidenShifts);
 	}
 
@@ -735,6 +773,16 @@ public:
 		return EMPTY_VARS;
 	}
 
+	inline void recycleColumn(MyVar* var){
+		if(pPricer_)
+			pPricer_->recycleColumn(var);
+	}
+
+	inline void recycleAllColumns(){
+		if(pPricer_)
+			pPricer_->recycleAllColumns();
+	}
+
 	inline bool branching_candidates(MyBranchingCandidate& candidate){
 		if(pBranchingRule_)
 			return pBranchingRule_->branching_candidates(candidate);
@@ -747,6 +795,15 @@ public:
 			return pBranchingRule_->column_candidates(candidate);
 		return false;
 	}
+
+	//strong branching: for each child, set the upper bounds of its variables to 0
+	//and solve the current LP from its basis with at most maxIterations iterations,
+	//objIncreases receives the increase of the objective (LARGE_SCORE if infeasible).
+	//Return false if the modeler cannot evaluate the children
+	virtual bool evaluateChildren(const vector<vector<MyVar*>>& childrenZeroVars,
+		vector<double>& objIncreases, int maxIterations){
+		return false;
+	}
 	//Set search strategy
 	inline void set_search_strategy(SearchStrategy searchStrategy){
 		if(pBranchingRule_)
@@ -936,6 +993,10 @@ public:
 
 	virtual double getDual(MyCons* cons, bool transformed = false)=0;
 
+	// Contiguous snapshot of the dual values of the last LP solution, indexed by MyCons::getIndex().
+	// It is read-only and unchanged until the next LP solution.
+	virtual const double* getDualValues()=0;
+
 	inline vector<double> getDuals(vector<MyCons*>& cons, bool transformed = false){
 		vector<double> dualValues(cons.size());
 		for(int i=0; i<cons.size(); ++i)
@@ -989,7 +1050,7 @@ public:
 
 	virtual int writeLP(string fileName)=0;
 
-	virtual void toString(MyObject* obj){ cout << obj->name_ << endl; }
+	virtual void toString(MyObject* obj){ cout << obj->getName() << endl; }
 
 	/**************
 	 * Getters *
@@ -1059,9 +1120,20 @@ public:
 		parameters_ = parameters;
 		setVerbosity(parameters_.verbose_);
 		logfile_ = parameters.logfile_;
+		if(!pMetricsStream_ && !parameters.metricsfile_.empty())
+			pMetricsStream_ = new Tools::LogOutput(parameters.metricsfile_, true);
 	}
 	inline string logfile() {return logfile_;}
 
+	// Metrics of the column generation: one JSON object per line in parameters_.metricsfile_.
+	// Check isMetrics() before building a line, so that nothing is computed when they are disabled.
+	// The modelers of concurrent workers append to the same file, so each line is written and flushed under a lock.
+	inline bool isMetrics() {return pMetricsStream_ != 0;}
+	inline void writeMetrics(const string& line) {
+		std::lock_guard<std::mutex> lock(s_metricsMutex);
+		(*pMetricsStream_) << line << std::endl;
+	}
+
 	inline SolverParam& getParameters() { return parameters_; }
 
 	inline void setLogFile(string fileName) {logfile_ = fileName;}
@@ -1134,6 +1206,10 @@ protected:
 	// log file where outputs must be written
 	string logfile_="";
 
+	// stream of the metrics of the column generation (null if disabled)
+	Tools::LogOutput* pMetricsStream_ = 0;
+	static std::mutex s_metricsMutex;
+
 	//Coin data
 	double infinity_=1.2343423E23;
 };
@@ -109,8 +109,8 @@ std::vector<int> parseList(std::string strList, char delimiter) {
     return intList;
 }
 
-//random generator of tools
-std::minstd_rand rdm0(0);
+//random generator of tools: each thread has its own stream
+thread_local std::minstd_rand rdm0(0);
 
 // Initialize the random generator with a given seed
 void initializeRandomGenerator(){
@@ -120,13 +120,43 @@ void initializeRandomGenerator(int rdmSeed){
 	rdm0 = getANewRandomGenerator(rdmSeed);
 }
 
+// Derive the seed of a stream from a master seed and the id of the stream
+// (mixing function of splitmix64)
+//
+int getStreamSeed(int masterSeed, int streamId){
+	uint64_t z = ((uint64_t) (uint32_t) masterSeed << 32) + (uint32_t) streamId;
+	z += 0x9e3779b97f4a7c15ULL;
+	z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+	z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+	z = z ^ (z >> 31);
+	// minstd_rand needs a seed in [1, 2^31-2]
+	return 1 + (int) (z % (minstd_rand::modulus - 1));
+}
+
+std::vector<int> splitRandomStream(int nbStreams){
+	int masterSeed = rdm0();
+	std::vector<int> seeds;
+	for (int i=0; i < nbStreams; i++)
+		seeds.push_back(getStreamSeed(masterSeed, i));
+	return seeds;
+}
+
+void initializeRandomStream(int rdmSeed){
+	rdm0.seed(rdmSeed);
+}
+
+minstd_rand& getRandomGenerator(){
+	return rdm0;
+}
+
 //Create a random generator
-//the objective is to be sure to have always the same sequence of number
+//the objective is to be sure to have always the same sequence of number:
+//the seed is drawn from the stream of the calling thread
 //
 minstd_rand getANewRandomGenerator(){
-	int rdmSeed = rand();
+	int rdmSeed = rdm0();
 	std::cout << "The new random seed of random generator is " << rdmSeed << std::endl;
-   minstd_rand rdm(rand());
+   minstd_rand rdm(rdmSeed);
    return rdm;
 }
 minstd_rand getANewRandomGenerator(int rdmSeed){
@@ -355,7 +385,7 @@ int containsWeekend(int start, int end){
 
 // constructor of Timer
 //
-Timer::Timer():isInit_(0), isStarted_(0), isStopped_(0) {
+Timer::Timer(bool isCpuTime):isCpuTime_(isCpuTime), isInit_(0), isStarted_(0), isStopped_(0) {
 	this->init();
 }
 
@@ -381,18 +411,7 @@ void Timer::start()  {
 	if (isStarted_)
 		throwError("Trying to start an already started timer!");
 
-#ifdef __MACH__ // OS X does not have clock_gettime, use clock_get_time
-	clock_serv_t cclock;
-	mach_timespec_t mts;
-	host_get_clock_service(mach_host_self(), CALENDAR_CLOCK, &cclock);
-	clock_get_time(cclock, &mts);
-	mach_port_deallocate(mach_task_self(), cclock);
-	cpuInit_.tv_sec = mts.tv_sec;
-	cpuInit_.tv_nsec = mts.tv_nsec;
-
-#else
-	clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &cpuInit_);
-#endif
+	getTime(cpuInit_);
 
 	cpuSinceStart_.tv_sec   = 0;
 	cpuSinceStart_.tv_nsec  = 0;
@@ -411,18 +430,7 @@ void Timer::stop() {
 
 	timespec cpuNow;
 
-#ifdef __MACH__ // OS X does not have clock_gettime, use clock_get_time
-	clock_serv_t cclock;
-	mach_timespec_t mts;
-	host_get_clock_service(mach_host_self(), CALENDAR_CLOCK, &cclock);
-	clock_get_time(cclock, &mts);
-	mach_port_deallocate(mach_task_self(), cclock);
-	cpuNow.tv_sec = mts.tv_sec;
-	cpuNow.tv_nsec = mts.tv_nsec;
-
-#else
-	clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &cpuNow);
-#endif
+	getTime(cpuNow);
 
 	if ( cpuNow.tv_nsec-cpuInit_.tv_nsec < 0 ) {
 		cpuSinceStart_.tv_sec   = cpuNow.tv_sec - cpuInit_.tv_sec - 1;
@@ -453,18 +461,7 @@ const double Timer::dSinceInit() {
 	if (isStarted_) {
 		timespec cpuNow;
 
-#ifdef __MACH__ // OS X does not have clock_gettime, use clock_get_time
-		clock_serv_t cclock;
-		mach_timespec_t mts;
-		host_get_clock_service(mach_host_self(), CALENDAR_CLOCK, &cclock);
-		clock_get_time(cclock, &mts);
-		mach_port_deallocate(mach_task_self(), cclock);
-		cpuNow.tv_sec = mts.tv_sec;
-		cpuNow.tv_nsec = mts.tv_nsec;
-
-#else
-		clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &cpuNow);
-#endif
+		getTime(cpuNow);
 
 		timespec cpuTmp;
 		if ( cpuNow.tv_nsec-cpuInit_.tv_nsec < 0 ) {
@@ -506,18 +503,7 @@ const double Timer::dSinceStart() {
 	else if (isStarted_) {
 		timespec cpuNow;
 
-#ifdef __MACH__ // OS X does not have clock_gettime, use clock_get_time
-		clock_serv_t cclock;
-		mach_timespec_t mts;
-		host_get_clock_service(mach_host_self(), CALENDAR_CLOCK, &cclock);
-		clock_get_time(cclock, &mts);
-		mach_port_deallocate(mach_task_self(), cclock);
-		cpuNow.tv_sec = mts.tv_sec;
-		cpuNow.tv_nsec = mts.tv_nsec;
-
-#else
-		clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &cpuNow);
-#endif
+		getTime(cpuNow);
 
 		if ( cpuNow.tv_nsec-cpuInit_.tv_nsec < 0 ) {
 			cpuSinceStart_.tv_sec   = cpuNow.tv_sec - cpuInit_.tv_sec - 1;
@@ -532,5 +518,54 @@ const double Timer::dSinceStart() {
 
 } //end dSinceStart
 
+// Read the clock of the timer: a monotonic wall clock, or the CPU time of the
+// process
+//
+void Timer::getTime(timespec& time) {
+
+#ifdef __MACH__ // OS X does not have clock_gettime, use clock_get_time
+	clock_serv_t cclock;
+	mach_timespec_t mts;
+	host_get_clock_service(mach_host_self(), CALENDAR_CLOCK, &cclock);
+	clock_get_time(cclock, &mts);
+	mach_port_deallocate(mach_task_self(), cclock);
+	time.tv_sec = mts.tv_sec;
+	time.tv_nsec = mts.tv_nsec;
+
+#else
+	clock_gettime(isCpuTime_ ? CLOCK_PROCESS_CPUTIME_ID : CLOCK_MONOTONIC, &time);
+#endif
+}
+
+// CPU time of the process in seconds
+//
+double cpuTime() {
+	return (double) clock() / CLOCKS_PER_SEC;
+}
+
+
+//-----------------------------------------------------------------------------
+//
+//  C l a s s   D e a d l i n e
+//
+//-----------------------------------------------------------------------------
+
+Deadline::Deadline(double timeLimitSeconds, const Deadline* pParent):
+	start_(std::chrono::steady_clock::now()) {
+	// bound the time limit so that the end point does not overflow the clock
+	double timeLimit = std::max(0.0, std::min(timeLimitSeconds, (double) LARGE_TIME));
+	end_ = start_ + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+		std::chrono::duration<double>(timeLimit));
+	if (pParent && pParent->end_ < end_) end_ = pParent->end_;
+}
+
+double Deadline::elapsed() const {
+	return std::chrono::duration<double>(std::chrono::steady_clock::now() - start_).count();
+}
+
+double Deadline::remaining() const {
+	return std::chrono::duration<double>(end_ - std::chrono::steady_clock::now()).count();
+}
+
 
 } // end namespace
@@ -24,6 +24,8 @@
 #include <algorithm>
 #include <cfloat>
 #include <random>
+#include <chrono>
+#include <cstdint>
 
 #define _USE_MATH_DEFINES // needed for the constant M_PI
 #include <math.h>
@@ -101,6 +103,19 @@ std::minstd_rand getANewRandomGenerator(int rdmSeed);
 void initializeRandomGenerator();
 void initializeRandomGenerator(int rdmSeed);
 
+// Random streams: the random generator of the tools is local to each thread.
+// Every worker, task or solver that runs concurrently with others starts its
+// own stream with initializeRandomStream, with a seed derived from a master
+// seed and the id of the stream, so that its draws do not depend on the
+// scheduling of the threads.
+//
+int getStreamSeed(int masterSeed, int streamId);
+// seeds of nbStreams independent streams split from the stream of this thread
+std::vector<int> splitRandomStream(int nbStreams);
+void initializeRandomStream(int rdmSeed);
+// random generator of this thread (e.g. for std::shuffle)
+std::minstd_rand& getRandomGenerator();
+
 
 //round with probability
 int roundWithProbability(double number);
@@ -178,11 +193,14 @@ class Timer
 public:
 
 	//constructor and destructor
+	// the timer measures the wall-clock time, unless isCpuTime is true: it then
+	// measures the CPU time of the process (summed over all its threads)
 	//
-	Timer();
+	Timer(bool isCpuTime = false);
 	~Timer() {}
 
 private:
+	bool isCpuTime_;
 	timespec cpuInit_;
 	timespec cpuSinceStart_;
 	timespec cpuSinceInit_;
@@ -208,6 +226,97 @@ public:
 	const double dSinceInit();
 	const double dSinceStart();
 
+private:
+	// read the clock of the timer
+	void getTime(timespec& time);
+};
+
+// CPU time of the process in seconds
+//
+double cpuTime();
+
+// Wall-clock deadline of a solution process, based on a monotonic clock.
+// A deadline can be carved from the deadline of the parent process (run, week,
+// component, LNS iteration, branch-and-price), and it then never ends after it.
+// Checking a deadline only reads the clock, so it can be done in hot loops.
+//
+class Deadline
+{
+public:
+	Deadline(double timeLimitSeconds, const Deadline* pParent = 0);
+
+	// time spent since the creation of the deadline and time left before it
+	// (negative once the deadline is passed)
+	double elapsed() const;
+	double remaining() const;
+	bool isExpired() const {return std::chrono::steady_clock::now() >= end_;}
+
+private:
+	std::chrono::steady_clock::time_point start_;
+	std::chrono::steady_clock::time_point end_;
+};
+
+// Matrix of bits stored in 64-bit words, e.g. the forbidden (day,shift) of a
+// nurse. Copying, merging and comparing two matrices of the same size work on
+// whole words, and the bits that differ between two matrices can be visited
+// without going through the bits that are equal.
+//
+class BitMatrix
+{
+public:
+	BitMatrix(int nbRows = 0, int nbCols = 1):
+		nbRows_(nbRows), nbCols_(nbCols), words_((nbRows*nbCols+63)/64, 0) {}
+
+	int nbRows() const {return nbRows_;}
+	int nbCols() const {return nbCols_;}
+
+	bool test(int row, int col = 0) const {
+		int i = row*nbCols_+col;
+		return (words_[i>>6] >> (i&63)) & 1;
+	}
+	void set(int row, int col = 0) {
+		int i = row*nbCols_+col;
+		words_[i>>6] |= uint64_t(1) << (i&63);
+	}
+	void reset(int row, int col = 0) {
+		int i = row*nbCols_+col;
+		words_[i>>6] &= ~(uint64_t(1) << (i&63));
+	}
+	void clear() {std::fill(words_.begin(), words_.end(), 0);}
+	bool any() const {
+		for (uint64_t w: words_) if (w) return true;
+		return false;
+	}
+
+	// merge the bits of a matrix of the same size
+	BitMatrix& operator|=(const BitMatrix& other) {
+		for (unsigned int w=0; w<words_.size(); w++) words_[w] |= other.words_[w];
+		return *this;
+	}
+	bool operator==(const BitMatrix& other) const {
+		return nbRows_ == other.nbRows_ && nbCols_ == other.nbCols_ && words_ == other.words_;
+	}
+	bool operator!=(const BitMatrix& other) const {return !(*this == other);}
+
+	// call visit(row, col, isSet) for every bit that differs from the same bit
+	// in a matrix of the same size; isSet is the value of the bit in this matrix
+	template<typename Visitor>
+	void visitDifferences(const BitMatrix& other, Visitor visit) const {
+		for (unsigned int w=0; w<words_.size(); w++) {
+			uint64_t diff = words_[w] ^ other.words_[w];
+			while (diff) {
+				int b = __builtin_ctzll(diff);
+				int i = (w<<6) + b;
+				visit(i/nbCols_, i%nbCols_, (bool) ((words_[w] >> b) & 1));
+				diff &= diff-1;
+			}
+		}
+	}
+
+private:
+	int nbRows_;
+	int nbCols_;
+	std::vector<uint64_t> words_;
 };
 
 // Instantiate an obect of this class to write directly in the attribute log
@@ -588,6 +588,9 @@ std::string ReadWrite::readStochasticSolverOptions(string strOptionFile, Stochas
 		if(!strcmp(title.c_str(), "nGenerationDemandsMax")){
 			file >> options.nGenerationDemandsMax_;
 		}
+		if(!strcmp(title.c_str(), "nEvaluationThreads")){
+			file >> options.nEvaluationThreads_;
+		}
 	}
 
   std::ifstream fin(strOptionFile.c_str());
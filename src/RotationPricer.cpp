@@ -8,6 +8,10 @@
 #include "RotationPricer.h"
 #include "BcpModeler.h"
 
+#include <atomic>
+#include <thread>
+#include <exception>
+
 /* namespace usage */
 using namespace std;
 
@@ -23,19 +27,24 @@ static char const * baseName = "rotation";
 /* Constructs the pricer object. */
 RotationPricer::RotationPricer(MasterProblem* master, const char* name, SolverParam param):
 		MyPricer(name), nbMaxRotationsToAdd_(20), nbSubProblemsToSolve_(15), nursesToSolve_(master->theNursesSorted_),
-		pMaster_(master), pScenario_(master->pScenario_), nbDays_(master->pDemand_->nbDays_), pModel_(master->getModel()), nb_int_solutions_(0)
+		pMaster_(master), pScenario_(master->pScenario_), nbDays_(master->pDemand_->nbDays_), pModel_(master->getModel()),
+		forbiddenShifts_(nbDays_, pScenario_->nbShifts_), forbiddenStartingDays_(nbDays_), nb_int_solutions_(0)
 {
 	// Initialize the parameters
 	initPricerParameters(param);
 
+	// Precompute the rows of the dual values of the nurses
+	initDualRows();
+
 	/* sort the nurses */
 	//   random_shuffle( nursesToSolve_.begin(), nursesToSolve_.end());
 }
 
 /* Destructs the pricer object. */
 RotationPricer::~RotationPricer() {
-	for(pair<const Contract*, SubProblem*> p: subProblems_)
-		delete p.second;
+	for(map<const Contract*, SubProblem*>& subProblems: subProblems_)
+		for(pair<const Contract*, SubProblem*> p: subProblems)
+			delete p.second;
 }
 
 void RotationPricer::initPricerParameters(SolverParam param){
@@ -45,8 +54,22 @@ void RotationPricer::initPricerParameters(SolverParam param){
 	nbSubProblemsToSolve_ = param.sp_nbnursestoprice_;
 	defaultSubprobemStrategy_ = param.sp_default_strategy_;
 	secondchanceSubproblemStrategy_ = param.sp_secondchance_strategy_;
+	nbThreads_ = (unsigned int) std::max(1, param.sp_nbthreads_);
+	layeredLabeling_ = param.sp_layered_labeling_;
+	bidirectionalLabeling_ = param.sp_bidirectional_labeling_;
 
 	currentSubproblemStrategy_ = defaultSubprobemStrategy_;
+
+	// one set of subproblems per thread
+	if(subProblems_.size() < nbThreads_)
+		subProblems_.resize(nbThreads_);
+	if(nbThreads_ > 1)
+		pricingWorkers_.resize(nbThreads_);
+
+	// the column pool is created only once, so that it survives the next solves
+	withColumnPool_ = param.sp_column_pool_size_ > 0;
+	if(withColumnPool_ && columnPool_.size() == 0)
+		columnPool_ = ColumnPool(pMaster_->getNbNurses(), param.sp_column_pool_size_);
 }
 
 /******************************************************
@@ -63,90 +86,101 @@ vector<MyVar*> RotationPricer::pricing(double bound, bool before_fathom){
 	double minDualCost = 0;
 	vector<LiveNurse*> nursesSolved;
 
-	for(vector<LiveNurse*>::iterator it0 = nursesToSolve_.begin(); it0 != nursesToSolve_.end();){
-
-		// RETRIEVE THE NURSE AND CHECK THAT HE/SHE IS NOT FORBIDDEN
-		LiveNurse* pNurse = *it0;
-		bool nurseForbidden = isNurseForbidden(pNurse->id_);
+	// The column disjoint option makes each subproblem depend on the rotations
+	// generated for the previous nurse, so it forces the sequential loop
+	if(nbThreads_ > 1 && !pModel_->getParameters().isColumnDisjoint_)
+		minDualCost = pricingInParallel(bound, nursesSolved);
+	else {
+		for(vector<LiveNurse*>::iterator it0 = nursesToSolve_.begin(); it0 != nursesToSolve_.end();){
 
-		// IF THE NURSE IS NOT FORBIDDEN, SOLVE THE SUBPROBLEM
-		if(!nurseForbidden){
+			// RETRIEVE THE NURSE AND CHECK THAT HE/SHE IS NOT FORBIDDEN
+			LiveNurse* pNurse = *it0;
+			bool nurseForbidden = isNurseForbidden(pNurse->id_);
 
-			// BUILD OR RE-USE THE SUBPROBLEM
-			SubProblem* subProblem = retriveSubproblem(pNurse);
+			// IF THE NURSE IS NOT FORBIDDEN, SOLVE THE SUBPROBLEM
+			if(!nurseForbidden){
 
-			// RETRIEVE DUAL VALUES
-			vector< vector<double> > workDualCosts(getWorkDualValues(pNurse));
-			vector<double> startWorkDualCosts(getStartWorkDualValues(pNurse));
-			vector<double> endWorkDualCosts(getEndWorkDualValues(pNurse));
-			double workedWeekendDualCost = getWorkedWeekendDualValue(pNurse);
-			DualCosts dualCosts (workDualCosts, startWorkDualCosts, endWorkDualCosts, workedWeekendDualCost, true);
+				// BUILD OR RE-USE THE SUBPROBLEM
+				SubProblem* subProblem = retriveSubproblem(pNurse);
 
-			// UPDATE FORBIDDEN SHIFTS
-			if (pModel_->getParameters().isColumnDisjoint_) {
-				addForbiddenShifts();
-			}
-			set<pair<int,int> > nurseForbiddenShifts(forbiddenShifts_);
-			pModel_->addForbiddenShifts(pNurse, nurseForbiddenShifts);
-
-			// SET SOLVING OPTIONS
-			SubproblemParam sp_param (currentSubproblemStrategy_,pNurse);
-
-			// DBG ***
-			// generateRandomForbiddenStartingDays();
+				// RETRIEVE DUAL VALUES
+				DualCosts dualCosts (pModel_->getDualValues(), dualRows_[pNurse->id_]);
 
-			// SOLVE THE PROBLEM
-			++ nbSPTried_;
-			subProblem->solve(pNurse, &dualCosts, sp_param, nurseForbiddenShifts, forbiddenStartingDays_, true ,
-					bound);
-
-			// RETRIEVE THE GENERATED ROTATIONS
-			newRotationsForNurse_ = subProblem->getRotations();
+				// UPDATE FORBIDDEN SHIFTS
+				if (pModel_->getParameters().isColumnDisjoint_) {
+					addForbiddenShifts();
+				}
+				Tools::BitMatrix nurseForbiddenShifts(forbiddenShifts_);
+				pModel_->addForbiddenShifts(pNurse, nurseForbiddenShifts);
+
+				// SET SOLVING OPTIONS
+				SubproblemParam sp_param (currentSubproblemStrategy_,pNurse);
+				sp_param.layeredLabeling(layeredLabeling_);
+				sp_param.bidirectionalLabeling(bidirectionalLabeling_);
+
+				// DBG ***
+				// generateRandomForbiddenStartingDays();
+
+				// PRICE THE COLUMN POOL, AND SOLVE THE PROBLEM ONLY IF IT DID NOT GIVE ANY ROTATION
+				if(!withColumnPool_ || !priceFromColumnPool(pNurse, dualCosts, nurseForbiddenShifts, bound)){
+					++ nbSPTried_;
+					Tools::Timer timerSP; timerSP.start();
+					subProblem->solve(pNurse, &dualCosts, sp_param, nurseForbiddenShifts, forbiddenStartingDays_, true ,
+							bound);
+					timerSP.stop();
+
+					// RETRIEVE THE GENERATED ROTATIONS
+					newRotationsForNurse_ = subProblem->getRotations();
+					if(pModel_->isMetrics())
+						writeSubproblemMetrics(pNurse, timerSP.dSinceStart(), subProblem->nLabelsCreated(),
+								subProblem->nLabelsDominated(), subProblem->bestReducedCost());
+				}
 
-			// DBG ***
-			// checkForbiddenStartingDays();
-			// recordSPStats(subProblem);
-			// for(Rotation& rot: newRotationsForNurse_){
-			// 	rot.checkDualCost(dualCosts);
-			// }
+				// DBG ***
+				// checkForbiddenStartingDays();
+				// recordSPStats(subProblem);
+				// for(Rotation& rot: newRotationsForNurse_){
+				// 	rot.checkDualCost(dualCosts);
+				// }
 
-			// ADD THE ROTATIONS TO THE MASTER PROBLEM
-			addRotationsToMaster();
+				// ADD THE ROTATIONS TO THE MASTER PROBLEM
+				addRotationsToMaster();
 
 
 
-		}
+			}
 
-		// CHECK IF THE SUBPROBLEM GENERATED NEW ROTATIONS
-		// If yes, store the nures
-		if(newRotationsForNurse_.size() > 0 && !nurseForbidden){
-			++nbSPSolvedWithSuccess_;
-			if(newRotationsForNurse_[0].dualCost_ < minDualCost)
-				minDualCost = newRotationsForNurse_[0].dualCost_;
+			// CHECK IF THE SUBPROBLEM GENERATED NEW ROTATIONS
+			// If yes, store the nures
+			if(newRotationsForNurse_.size() > 0 && !nurseForbidden){
+				++nbSPSolvedWithSuccess_;
+				if(newRotationsForNurse_[0].dualCost_ < minDualCost)
+					minDualCost = newRotationsForNurse_[0].dualCost_;
 
-			nursesToSolve_.erase(it0);
-			nursesSolved.push_back(pNurse);
-		}
-		// Otherwise (no rotation generated or nurse is forbidden), try the next nurse
-		else {
-			++it0;
-
-			// If it was the last nurse to search AND no improving column was found AND we may want to solve SP with
-			// different parameters -> change these parameters and go for another loop of solving
-			if( it0 == nursesToSolve_.end() && allNewColumns_.empty() && withSecondchance_){
-				if(currentSubproblemStrategy_ == defaultSubprobemStrategy_){
-					nursesToSolve_.insert(nursesToSolve_.end(), nursesSolved.begin(), nursesSolved.end());
-					it0 = nursesToSolve_.begin();
-					currentSubproblemStrategy_ = secondchanceSubproblemStrategy_;
-				} else if (currentSubproblemStrategy_ == secondchanceSubproblemStrategy_) {
-					currentSubproblemStrategy_ = defaultSubprobemStrategy_;
+				nursesToSolve_.erase(it0);
+				nursesSolved.push_back(pNurse);
+			}
+			// Otherwise (no rotation generated or nurse is forbidden), try the next nurse
+			else {
+				++it0;
+
+				// If it was the last nurse to search AND no improving column was found AND we may want to solve SP with
+				// different parameters -> change these parameters and go for another loop of solving
+				if( it0 == nursesToSolve_.end() && allNewColumns_.empty() && withSecondchance_){
+					if(currentSubproblemStrategy_ == defaultSubprobemStrategy_){
+						nursesToSolve_.insert(nursesToSolve_.end(), nursesSolved.begin(), nursesSolved.end());
+						it0 = nursesToSolve_.begin();
+						currentSubproblemStrategy_ = secondchanceSubproblemStrategy_;
+					} else if (currentSubproblemStrategy_ == secondchanceSubproblemStrategy_) {
+						currentSubproblemStrategy_ = defaultSubprobemStrategy_;
+					}
 				}
 			}
-		}
 
-		//if the maximum number of subproblem solved is reached, break.
-		if(nbSPSolvedWithSuccess_ == nbSubProblemsToSolve_)
-			break;
+			//if the maximum number of subproblem solved is reached, break.
+			if(nbSPSolvedWithSuccess_ == nbSubProblemsToSolve_)
+				break;
+		}
 	}
 
 	//Add the nurse in nursesSolved at the end
@@ -169,89 +203,367 @@ vector<MyVar*> RotationPricer::pricing(double bound, bool before_fathom){
 }
 
 /******************************************************
- * Get the duals values per day for a nurse
+ * Perform pricing with several threads
  ******************************************************/
-vector< vector<double> > RotationPricer::getWorkDualValues(LiveNurse* pNurse){
-	vector< vector<double> > dualValues(nbDays_);
-	int i = pNurse->id_;
-	int p = pNurse->pContract_->id_;
-
-	/* Min/Max constraints */
-	double minWorkedDays = pModel_->getDual(pMaster_->minWorkedDaysCons_[i], true);
-	double maxWorkedDays = pModel_->getDual(pMaster_->maxWorkedDaysCons_[i], true);
-
-	double minWorkedDaysAvg = pMaster_->isMinWorkedDaysAvgCons_[i] ? pModel_->getDual(pMaster_->minWorkedDaysAvgCons_[i], true):0.0;
-	double maxWorkedDaysAvg = pMaster_->isMaxWorkedDaysAvgCons_[i] ? pModel_->getDual(pMaster_->maxWorkedDaysAvgCons_[i], true):0.0;
-
-	double minWorkedDaysContractAvg = pMaster_->isMinWorkedDaysContractAvgCons_[p] ?
-			pModel_->getDual(pMaster_->minWorkedDaysContractAvgCons_[p], true):0.0;
-	double maxWorkedDaysContractAvg = pMaster_->isMaxWorkedDaysContractAvgCons_[p] ?
-			pModel_->getDual(pMaster_->maxWorkedDaysContractAvgCons_[p], true):0.0;
-
-	for(int k=0; k<nbDays_; ++k){
-		//initialize vector
-		vector<double> dualValues2(pScenario_->nbShifts_-1);
-
-		for(int s=1; s<pScenario_->nbShifts_; ++s){
-			/* Min/Max constraints */
-			dualValues2[s-1] = minWorkedDays + minWorkedDaysAvg + minWorkedDaysContractAvg;
-			dualValues2[s-1] += maxWorkedDays + maxWorkedDaysAvg + maxWorkedDaysContractAvg;
-
-			/* Skills coverage */
-			dualValues2[s-1] += pModel_->getDual(
-					pMaster_->numberOfNursesByPositionCons_[k][s-1][pNurse->pPosition_->id_], true);
+double RotationPricer::pricingInParallel(double bound, vector<LiveNurse*>& nursesSolved){
+	double minDualCost = 0;
+
+	// the subproblem of a nurse, and its results once solved by a worker
+	struct PricingTask{
+		LiveNurse* pNurse;
+		Tools::BitMatrix forbiddenShifts;
+		bool fromPool;
+		vector<Rotation> rotations;
+		double time;
+		int nLabelsCreated, nLabelsDominated;
+		double bestReducedCost;
+		std::exception_ptr error;
+	};
+
+	while(true){
+
+		// PREPARE THE SUBPROBLEMS OF THE NURSES THAT ARE NOT FORBIDDEN
+		// The forbidden shifts are read here, so that the workers never access the model:
+		// they only read the dual snapshot, which does not change during the pricing.
+		// The column pool is priced here too, and the subproblem is solved only if it gave nothing.
+		vector<PricingTask> tasks;
+		for(LiveNurse* pNurse: nursesToSolve_){
+			if(isNurseForbidden(pNurse->id_))
+				continue;
+			PricingTask task = {pNurse, forbiddenShifts_, false, vector<Rotation>(), 0, 0, 0, 0, nullptr};
+			pModel_->addForbiddenShifts(pNurse, task.forbiddenShifts);
+			DualCosts dualCosts (pModel_->getDualValues(), dualRows_[pNurse->id_]);
+			if(withColumnPool_ && priceFromColumnPool(pNurse, dualCosts, task.forbiddenShifts, bound)){
+				task.fromPool = true;
+				task.rotations = newRotationsForNurse_;
+			}
+			tasks.push_back(task);
 		}
 
-		//store vector
-		dualValues[k] = dualValues2;
+		// SOLVE THE SUBPROBLEMS WITH THE WORKERS
+		// Worker w uses its own subproblems, and the exceptions are sent back to this thread
+		const double* duals = pModel_->getDualValues();
+		std::atomic<unsigned int> nextTask(0);
+		std::mutex doneMutex;
+		std::condition_variable taskDone;
+		vector<char> done(tasks.size(), 0);
+		for(unsigned int i=0; i<tasks.size(); ++i)
+			done[i] = tasks[i].fromPool;
+		pricingWorkers_.start([&](unsigned int w){
+			if(w >= nbThreads_)
+				return;
+			for(unsigned int i = nextTask++; i < tasks.size(); i = nextTask++){
+				PricingTask& task = tasks[i];
+				if(task.fromPool)
+					continue;
+				try {
+					SubProblem* subProblem = retriveSubproblem(task.pNurse, w);
+					DualCosts dualCosts (duals, dualRows_[task.pNurse->id_]);
+					SubproblemParam sp_param (currentSubproblemStrategy_, task.pNurse);
+					sp_param.layeredLabeling(layeredLabeling_);
+					sp_param.bidirectionalLabeling(bidirectionalLabeling_);
+					Tools::Timer timerSP; timerSP.start();
+					subProblem->solve(task.pNurse, &dualCosts, sp_param, task.forbiddenShifts, forbiddenStartingDays_,
+							true, bound);
+					timerSP.stop();
+					task.time = timerSP.dSinceStart();
+					task.rotations = subProblem->getRotations();
+					// the subproblem may be solved for another nurse before the merge
+					task.nLabelsCreated = subProblem->nLabelsCreated();
+					task.nLabelsDominated = subProblem->nLabelsDominated();
+					task.bestReducedCost = subProblem->bestReducedCost();
+				}
+				catch(...) {
+					task.error = std::current_exception();
+				}
+				std::lock_guard<std::mutex> lock(doneMutex);
+				done[i] = 1;
+				taskDone.notify_all();
+			}
+		});
+
+		// ADD THE ROTATIONS TO THE MASTER PROBLEM IN THE ORDER OF THE NURSES
+		// Stop as soon as the maximum number of successful subproblems is reached: the
+		// rotations of the next nurses are dropped as in the sequential loop.
+		vector<LiveNurse*> tasksSolved;
+		std::exception_ptr error;
+		try {
+			for(unsigned int i=0; i<tasks.size(); ++i){
+				std::unique_lock<std::mutex> lock(doneMutex);
+				taskDone.wait(lock, [&](){return done[i] != 0;});
+				lock.unlock();
+
+				PricingTask& task = tasks[i];
+				if(task.error)
+					std::rethrow_exception(task.error);
+				newRotationsForNurse_ = task.rotations;
+				if(!task.fromPool){
+					++ nbSPTried_;
+					if(pModel_->isMetrics())
+						writeSubproblemMetrics(task.pNurse, task.time, task.nLabelsCreated, task.nLabelsDominated,
+								task.bestReducedCost);
+				}
+
+				// the ids have been drawn concurrently, so set them again to have reproducible names
+				for(Rotation& rot: newRotationsForNurse_)
+					rot.id_ = Rotation::s_count++;
+				addRotationsToMaster();
+
+				if(newRotationsForNurse_.size() > 0){
+					++nbSPSolvedWithSuccess_;
+					if(newRotationsForNurse_[0].dualCost_ < minDualCost)
+						minDualCost = newRotationsForNurse_[0].dualCost_;
+					tasksSolved.push_back(task.pNurse);
+				}
+
+				if(nbSPSolvedWithSuccess_ == nbSubProblemsToSolve_)
+					break;
+			}
+		}
+		catch(...) {
+			error = std::current_exception();
+		}
+
+		// the workers stop taking nurses, and the tasks must outlive the ones they are solving
+		nextTask = tasks.size();
+		pricingWorkers_.wait();
+		if(error)
+			std::rethrow_exception(error);
+
+		// remove the nurses that produced rotations from the nurses to solve
+		for(LiveNurse* pNurse: tasksSolved)
+			nursesToSolve_.erase(std::find(nursesToSolve_.begin(), nursesToSolve_.end(), pNurse));
+		nursesSolved.insert(nursesSolved.end(), tasksSolved.begin(), tasksSolved.end());
+
+		//if the maximum number of subproblem solved is reached, break.
+		if(nbSPSolvedWithSuccess_ == nbSubProblemsToSolve_)
+			break;
+
+		// All the nurses have been solved AND no improving column was found AND we may want to solve SP with
+		// different parameters -> change these parameters and go for another loop of solving
+		if(allNewColumns_.empty() && withSecondchance_){
+			if(currentSubproblemStrategy_ == defaultSubprobemStrategy_){
+				nursesToSolve_.insert(nursesToSolve_.end(), nursesSolved.begin(), nursesSolved.end());
+				currentSubproblemStrategy_ = secondchanceSubproblemStrategy_;
+				continue;
+			} else if (currentSubproblemStrategy_ == secondchanceSubproblemStrategy_) {
+				currentSubproblemStrategy_ = defaultSubprobemStrategy_;
+			}
+		}
+		break;
 	}
 
-	return dualValues;
+	return minDualCost;
 }
 
+/******************************************************
+ * Pricing workers
+ ******************************************************/
+PricingWorkers::~PricingWorkers(){
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		quit_ = true;
+	}
+	jobStarted_.notify_all();
+	for(std::thread& worker: workers_)
+		worker.join();
+}
 
-vector<double> RotationPricer::getStartWorkDualValues(LiveNurse* pNurse){
-	int i = pNurse->id_;
-	vector<double> dualValues(nbDays_);
+void PricingWorkers::resize(unsigned int nbWorkers){
+	std::lock_guard<std::mutex> lock(mutex_);
+	// the new workers wait for the jobs after the current one
+	while(workers_.size() < nbWorkers)
+		workers_.push_back(std::thread(&PricingWorkers::run, this, workers_.size(), jobId_));
+}
 
-	//get dual value associated to the source
-	dualValues[0] =  pModel_->getDual(pMaster_->restFlowCons_[i][0], true);
-	//get dual values associated to the work flow constraints
-	//don't take into account the last which is the sink
-	for(int k=1; k<nbDays_; ++k)
-		dualValues[k] = pModel_->getDual(pMaster_->workFlowCons_[i][k-1], true);
+void PricingWorkers::start(std::function<void(unsigned int)> job){
+	std::lock_guard<std::mutex> lock(mutex_);
+	job_ = job;
+	++jobId_;
+	nbRunning_ = workers_.size();
+	jobStarted_.notify_all();
+}
 
-	return dualValues;
+void PricingWorkers::wait(){
+	std::unique_lock<std::mutex> lock(mutex_);
+	jobDone_.wait(lock, [this](){return nbRunning_ == 0;});
 }
 
-vector<double> RotationPricer::getEndWorkDualValues(LiveNurse* pNurse){
-	int i = pNurse->id_;
-	vector<double> dualValues(nbDays_);
+void PricingWorkers::run(unsigned int w, int lastJob){
+	std::unique_lock<std::mutex> lock(mutex_);
+	while(true){
+		jobStarted_.wait(lock, [&](){return quit_ || jobId_ != lastJob;});
+		if(quit_)
+			return;
+		lastJob = jobId_;
+		std::function<void(unsigned int)> job = job_;
+		lock.unlock();
+		job(w);
+		lock.lock();
+		if(--nbRunning_ == 0)
+			jobDone_.notify_all();
+	}
+}
 
-	//get dual values associated to the work flow constraints
-	//don't take into account the first which is the source
-	//take into account the cost, if the last day worked is k
-	for(int k=0; k<nbDays_-1; ++k)
-		dualValues[k] = -pModel_->getDual(pMaster_->restFlowCons_[i][k+1], true);
+/******************************************************
+ * Column pool
+ ******************************************************/
+void RotationPricer::recycleColumn(MyVar* var){
+	if(withColumnPool_)
+		columnPool_.recycle(var->getPattern());
+}
 
-	//get dual value associated to the sink
-	dualValues[nbDays_-1] =  pModel_->getDual(
-			pMaster_->workFlowCons_[i][nbDays_-1], true);
+void RotationPricer::recycleAllColumns(){
+	if(withColumnPool_)
+		columnPool_.recycleAll();
+}
 
-	return dualValues;
+bool RotationPricer::priceFromColumnPool(LiveNurse* pNurse, DualCosts& dualCosts,
+		const Tools::BitMatrix& forbiddenDayShifts, double bound){
+	newRotationsForNurse_ = columnPool_.price(pNurse->id_, dualCosts, forbiddenDayShifts, forbiddenStartingDays_, bound);
+	// the rotations are new columns for the master
+	for(Rotation& rot: newRotationsForNurse_)
+		rot.id_ = Rotation::s_count++;
+	return !newRotationsForNurse_.empty();
 }
 
-double RotationPricer::getWorkedWeekendDualValue(LiveNurse* pNurse){
-	int id = pNurse->id_;
-	double dualVal = pModel_->getDual(pMaster_->maxWorkedWeekendCons_[id], true);
-	if (pMaster_->isMaxWorkedWeekendAvgCons_[id]) {
-		dualVal += pModel_->getDual(pMaster_->maxWorkedWeekendAvgCons_[id], true);
+void ColumnPool::add(Rotation& rotation, bool inLP){
+	vector<double> pattern = rotation.getCompactPattern();
+	map< vector<double>, int >::iterator it = index_.find(pattern);
+	vector<PoolColumn>& columns = columnsByNurse_[rotation.nurseId_];
+	clock_++;
+	if(it != index_.end()){
+		columns[it->second].inLP_ = inLP;
+		columns[it->second].lastUse_ = clock_;
+		return;
+	}
+
+	PoolColumn column = {rotation, vector<int>(), inLP, clock_};
+	for(pair<int,int> p: rotation.shifts_)
+		column.shifts_.push_back(p.second);
+
+	if((int) columns.size() < maxSizePerNurse_){
+		index_[pattern] = columns.size();
+		columns.push_back(column);
+		return;
 	}
-	if (pMaster_->isMaxWorkedWeekendContractAvgCons_[pNurse->pContract_->id_]) {
-		dualVal += pModel_->getDual(pMaster_->maxWorkedWeekendContractAvgCons_[pNurse->pContract_->id_], true);
+
+	// the pool of the nurse is full: replace the least recently used column that is not in the LP (if any)
+	int oldest = -1;
+	for(unsigned int i=0; i<columns.size(); i++)
+		if(!columns[i].inLP_ && (oldest < 0 || columns[i].lastUse_ < columns[oldest].lastUse_))
+			oldest = i;
+	if(oldest < 0)
+		return;
+	index_.erase(columns[oldest].rotation_.getCompactPattern());
+	index_[pattern] = oldest;
+	columns[oldest] = column;
+}
+
+void ColumnPool::recycle(const vector<double>& pattern){
+	map< vector<double>, int >::iterator it = index_.find(pattern);
+	if(it != index_.end())
+		columnsByNurse_[(int)pattern[0]][it->second].inLP_ = false;
+}
+
+void ColumnPool::recycleAll(){
+	for(vector<PoolColumn>& columns: columnsByNurse_)
+		for(PoolColumn& column: columns)
+			column.inLP_ = false;
+}
+
+vector<Rotation> ColumnPool::price(int nurseId, DualCosts& costs, const Tools::BitMatrix& forbiddenDayShifts,
+		const Tools::BitMatrix& forbiddenStartingDays, double bound){
+	vector<Rotation> rotations;
+	clock_++;
+	for(PoolColumn& column: columnsByNurse_[nurseId]){
+		if(column.inLP_) continue;
+		Rotation& rot = column.rotation_;
+		if(forbiddenStartingDays.test(rot.firstDay_)) continue;
+
+		// same computation as Rotation::checkDualCost, on the flat shifts
+		bool isForbidden = false;
+		double dualCost = rot.cost_;
+		for(unsigned int l=0; l<column.shifts_.size(); ++l){
+			int k = rot.firstDay_+l, s = column.shifts_[l];
+			if(forbiddenDayShifts.test(k,s)){
+				isForbidden = true;
+				break;
+			}
+			dualCost -= costs.dayShiftWorkCost(k, s-1);
+			if(Tools::isSaturday(k))
+				dualCost -= costs.workedWeekendCost();
+		}
+		if(isForbidden) continue;
+		dualCost -= costs.startWorkCost(rot.firstDay_);
+		dualCost -= costs.endWorkCost(rot.firstDay_+rot.length_-1);
+		if(Tools::isSunday(rot.firstDay_))
+			dualCost -= costs.workedWeekendCost();
+
+		// same tolerance as in the subproblems
+		if(dualCost < bound - EPSILON){
+			rotations.push_back(rot);
+			rotations.back().dualCost_ = dualCost;
+			column.lastUse_ = clock_;
+		}
 	}
+	std::stable_sort(rotations.begin(), rotations.end(), Rotation::compareDualCost);
+	return rotations;
+}
 
-	return dualVal;
+/******************************************************
+ * Precompute the rows of the dual values of each nurse
+ ******************************************************/
+void RotationPricer::initDualRows(){
+	dualRows_.resize(pMaster_->getNbNurses());
+	for(LiveNurse* pNurse: pMaster_->theLiveNurses_){
+		int i = pNurse->id_;
+		int p = pNurse->pContract_->id_;
+		NurseDualRows& rows = dualRows_[i];
+
+		/* Min/Max constraints */
+		rows.minWorkedDaysRows_.push_back(pMaster_->minWorkedDaysCons_[i]->getIndex());
+		if(pMaster_->isMinWorkedDaysAvgCons_[i])
+			rows.minWorkedDaysRows_.push_back(pMaster_->minWorkedDaysAvgCons_[i]->getIndex());
+		if(pMaster_->isMinWorkedDaysContractAvgCons_[p])
+			rows.minWorkedDaysRows_.push_back(pMaster_->minWorkedDaysContractAvgCons_[p]->getIndex());
+		rows.maxWorkedDaysRows_.push_back(pMaster_->maxWorkedDaysCons_[i]->getIndex());
+		if(pMaster_->isMaxWorkedDaysAvgCons_[i])
+			rows.maxWorkedDaysRows_.push_back(pMaster_->maxWorkedDaysAvgCons_[i]->getIndex());
+		if(pMaster_->isMaxWorkedDaysContractAvgCons_[p])
+			rows.maxWorkedDaysRows_.push_back(pMaster_->maxWorkedDaysContractAvgCons_[p]->getIndex());
+
+		/* Skills coverage */
+		rows.nbWorkShifts_ = pScenario_->nbShifts_-1;
+		rows.workRows_.resize(nbDays_*rows.nbWorkShifts_);
+		for(int k=0; k<nbDays_; ++k)
+			for(int s=1; s<pScenario_->nbShifts_; ++s)
+				rows.workRows_[k*rows.nbWorkShifts_+s-1] =
+						pMaster_->numberOfNursesByPositionCons_[k][s-1][pNurse->pPosition_->id_]->getIndex();
+
+		/* Flow constraints */
+		// start: the source for the first day, then the work flow constraints
+		rows.startWorkRows_.resize(nbDays_);
+		rows.startWorkRows_[0] = pMaster_->restFlowCons_[i][0]->getIndex();
+		for(int k=1; k<nbDays_; ++k)
+			rows.startWorkRows_[k] = pMaster_->workFlowCons_[i][k-1]->getIndex();
+		// end: the opposite of the rest flow constraints, then the sink for the last day
+		rows.endWorkRows_.resize(nbDays_);
+		rows.endWorkSigns_.resize(nbDays_);
+		for(int k=0; k<nbDays_-1; ++k){
+			rows.endWorkRows_[k] = pMaster_->restFlowCons_[i][k+1]->getIndex();
+			rows.endWorkSigns_[k] = -1.0;
+		}
+		rows.endWorkRows_[nbDays_-1] = pMaster_->workFlowCons_[i][nbDays_-1]->getIndex();
+		rows.endWorkSigns_[nbDays_-1] = 1.0;
+
+		/* Weekends */
+		rows.workedWeekendRows_.push_back(pMaster_->maxWorkedWeekendCons_[i]->getIndex());
+		if(pMaster_->isMaxWorkedWeekendAvgCons_[i])
+			rows.workedWeekendRows_.push_back(pMaster_->maxWorkedWeekendAvgCons_[i]->getIndex());
+		if(pMaster_->isMaxWorkedWeekendContractAvgCons_[p])
+			rows.workedWeekendRows_.push_back(pMaster_->maxWorkedWeekendContractAvgCons_[p]->getIndex());
+	}
 }
 
 /******************************************************
@@ -270,17 +582,18 @@ void RotationPricer::addForbiddenShifts(){
 	//forbid shifts of the best rotation
 	if(bestDualcost != DBL_MAX)
 		for(pair<int,int> pair: bestRotation->shifts_)
-			forbiddenShifts_.insert(pair);
+			forbiddenShifts_.set(pair.first, pair.second);
 }
 
 // Returns a pointer to the right subproblem
-SubProblem* RotationPricer::retriveSubproblem(LiveNurse* pNurse){
+SubProblem* RotationPricer::retriveSubproblem(LiveNurse* pNurse, int thread){
 	SubProblem* subProblem;
-	map<const Contract*, SubProblem*>::iterator it =  subProblems_.find(pNurse->pContract_);
+	map<const Contract*, SubProblem*>& subProblems = subProblems_[thread];
+	map<const Contract*, SubProblem*>::iterator it =  subProblems.find(pNurse->pContract_);
 	// Each contract has one subproblem. If it has not already been created, create it.
-	if( it == subProblems_.end() ){
-		subProblem = new SubProblem(pScenario_, nbDays_, pNurse->pContract_, pMaster_->pInitState_);
-		subProblems_.insert(it, pair<const Contract*, SubProblem*>(pNurse->pContract_, subProblem));
+	if( it == subProblems.end() ){
+		subProblem = SubProblem::buildFromCache(pScenario_, nbDays_, pNurse->pContract_, pMaster_->pInitState_);
+		subProblems.insert(it, pair<const Contract*, SubProblem*>(pNurse->pContract_, subProblem));
 	} else {
 		subProblem = it->second;
 	}
@@ -309,6 +622,11 @@ void RotationPricer::addRotationsToMaster(){
 		if(nbRotationsAdded >= nbMaxRotationsToAdd_)
 			break;
 	}
+
+	// FINALLY, STORE ALL THE ROTATIONS IN THE COLUMN POOL (those that were not added are not in the LP)
+	if(withColumnPool_)
+		for(unsigned int i=0; i<newRotationsForNurse_.size(); ++i)
+			columnPool_.add(newRotationsForNurse_[i], (int) i < nbRotationsAdded);
 }
 
 // Sort the rotations that just were generated for a nurse. Default option is sort by increasing reduced cost but we
@@ -381,6 +699,20 @@ void RotationPricer::printStatSPSolutions(){
 	printf("\n");
 }
 
+// Write one JSON line with the statistics of the last solve of the subproblem of a nurse
+void RotationPricer::writeSubproblemMetrics(LiveNurse* pNurse, double time, int nLabelsCreated, int nLabelsDominated,
+		double bestReducedCost){
+	std::stringstream line;
+	line << "{\"event\":\"subproblem\",\"nurse\":" << pNurse->id_;
+	line << ",\"strategy\":" << currentSubproblemStrategy_;
+	line << ",\"time\":" << time;
+	line << ",\"labels_created\":" << nLabelsCreated;
+	line << ",\"labels_dominated\":" << nLabelsDominated;
+	line << ",\"columns\":" << newRotationsForNurse_.size();
+	line << ",\"min_reduced_cost\":" << bestReducedCost << "}";
+	pModel_->writeMetrics(line.str());
+}
+
 
 
 
@@ -407,17 +739,16 @@ void RotationPricer::printStatSPSolutions(){
 //}
 
 void RotationPricer::generateRandomForbiddenStartingDays(){
-	set<int> randomForbiddenStartingDays;
+	forbiddenStartingDays_.clear();
 	for(int m=0; m<5; m++){
 		int k = Tools::randomInt(0, nbDays_-1);
-		randomForbiddenStartingDays.insert(k);
+		forbiddenStartingDays_.set(k);
 	}
-	forbiddenStartingDays_ = randomForbiddenStartingDays;
 }
 void RotationPricer::checkForbiddenStartingDays(){
 	for(Rotation& rot: newRotationsForNurse_){
 		int startingDay = rot.firstDay_;
-		if(forbiddenStartingDays_.find(startingDay) != forbiddenStartingDays_.end()){
+		if(forbiddenStartingDays_.test(startingDay)){
 			cout << "# On a généré une rotation qui commence un jour interdit !" << endl;
 			getchar();
 		}
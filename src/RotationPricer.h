@@ -15,11 +15,113 @@
 #include "SubProblem.h"
 #include "Modeler.h"
 
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+
 /* namespace usage */
 using namespace std;
 
 
 
+//---------------------------------------------------------------------------
+//
+// C l a s s   C o l u m n P o o l
+//
+// Stores the rotations generated by the pricer, keyed by their compact pattern,
+// together with their cost. The rotations that are not in the LP anymore (deleted
+// by the solver, not added to the master, or from a previous solve of the same
+// master) are priced against the current duals before solving the subproblems.
+//
+//---------------------------------------------------------------------------
+class ColumnPool
+{
+public:
+   ColumnPool(int nbNurses = 0, int maxSizePerNurse = 0):
+      columnsByNurse_(nbNurses), maxSizePerNurse_(maxSizePerNurse) {}
+
+   // Store a rotation (its cost must be computed); inLP is true if it is a column of the LP.
+   // If the rotation is already stored, only its status is updated. When the pool of the nurse
+   // is full, the rotation replaces the column out of the LP that was used the least recently.
+   void add(Rotation& rotation, bool inLP);
+
+   // The column with this compact pattern has been removed from the LP
+   void recycle(const vector<double>& pattern);
+
+   // All the columns have been removed from the LP (e.g., a new solve starts)
+   void recycleAll();
+
+   // Return the rotations of the nurse that are not in the LP and whose reduced cost is
+   // smaller than bound, sorted by increasing reduced cost (these columns are marked as used)
+   vector<Rotation> price(int nurseId, DualCosts& costs, const Tools::BitMatrix& forbiddenDayShifts,
+         const Tools::BitMatrix& forbiddenStartingDays, double bound);
+
+   int size() {return index_.size();}
+
+protected:
+   struct PoolColumn {
+      Rotation rotation_;
+      vector<int> shifts_;   // shift of each day of the rotation, from its first day
+      bool inLP_;
+      int lastUse_;          // value of the clock when the column was last added or priced out
+   };
+
+   // Rotations of each nurse, and position of each pattern in these vectors
+   vector< vector<PoolColumn> > columnsByNurse_;
+   map< vector<double>, int > index_;
+
+   // Maximum number of rotations stored for each nurse
+   int maxSizePerNurse_;
+
+   // Incremented at each call to add or price, to find the least recently used columns
+   int clock_ = 0;
+};
+
+
+
+//---------------------------------------------------------------------------
+//
+// C l a s s   P r i c i n g W o r k e r s
+//
+// Threads that live as long as the pricer, so that they are not created at
+// each pricing. At each pricing, every worker runs the same job, in which it
+// takes the nurses to solve from a shared index.
+//
+//---------------------------------------------------------------------------
+class PricingWorkers
+{
+public:
+   PricingWorkers() {}
+   ~PricingWorkers();
+
+   // Create new workers until there are nbWorkers of them (the workers are never removed)
+   void resize(unsigned int nbWorkers);
+
+   // Run job(w) in each worker w, without waiting for the end of the job.
+   // The job must not throw.
+   void start(std::function<void(unsigned int)> job);
+
+   // Wait until every worker has returned from the current job
+   void wait();
+
+   unsigned int size() {return workers_.size();}
+
+protected:
+   // Loop of worker w: wait for a job newer than lastJob, run it, and so on until quit_
+   void run(unsigned int w, int lastJob);
+
+   vector<std::thread> workers_;
+   std::mutex mutex_;
+   std::condition_variable jobStarted_, jobDone_;
+   std::function<void(unsigned int)> job_;
+   int jobId_ = 0;                  // incremented at each new job
+   unsigned int nbRunning_ = 0;     // number of workers that have not returned from the current job
+   bool quit_ = false;
+};
+
+
+
 //---------------------------------------------------------------------------
 //
 // C l a s s   R o t a t i o n P r i c e r
@@ -36,6 +138,10 @@ public:
    /* perform pricing */
    vector<MyVar*> pricing(double bound=0, bool before_fathom = true);
 
+   /* store the columns removed from the LP in the column pool */
+   void recycleColumn(MyVar* var);
+   void recycleAllColumns();
+
    // Initialize parameters
    void initPricerParameters(SolverParam param);
 
@@ -49,7 +155,13 @@ protected:
    Modeler* pModel_;
    vector<LiveNurse*> nursesToSolve_;
    // One subproblem per contract because the consecutive same shift constraints vary by contract.
-   map<const Contract*, SubProblem*> subProblems_;
+   // There is one such map per pricing thread, so that each thread owns its subproblems.
+   vector< map<const Contract*, SubProblem*> > subProblems_;
+   // Rows of the dual values of each nurse (indexed by nurse id), read in the dual snapshot of the model
+   vector<NurseDualRows> dualRows_;
+   // Pool of the rotations generated so far, priced before the subproblems (if sp_column_pool_size_ > 0)
+   ColumnPool columnPool_;
+   bool withColumnPool_ = false;
 
    // DATA - Solutions, rotations, etc.
    //
@@ -63,9 +175,10 @@ protected:
 
    // SETTINGS - Options for forbidden shifts, nurses, starting days, etc.
    //
-   set<pair<int,int> > forbiddenShifts_;
+   // bit matrices of the forbidden (day,shift) and of the forbidden starting days (one column)
+   Tools::BitMatrix forbiddenShifts_;
    set<int> forbiddenNursesIds_;
-   set<int> forbiddenStartingDays_;
+   Tools::BitMatrix forbiddenStartingDays_;
    set<int> forbiddenEndingDays_;
 
    // SETTINGS - Options for the neighborhood. need of an original to reset at the end of each node when optimality has
@@ -75,12 +188,20 @@ protected:
    int defaultSubprobemStrategy_ = 0;
    int secondchanceSubproblemStrategy_ = 0;
    int currentSubproblemStrategy_ = 0;
+   bool layeredLabeling_ = false;
+   bool bidirectionalLabeling_ = false;
 
    // SETTINGS - Settings for the maximum number of problems to solve and of rotations to add to the master problem
    //
    int nbMaxRotationsToAdd_ = 0;
    int nbSubProblemsToSolve_ = 0;
 
+   // SETTINGS - Number of threads used to solve the subproblems of the nurses concurrently
+   //
+   unsigned int nbThreads_ = 1;
+   // workers that solve the subproblems when nbThreads_ > 1 (created once for all the pricings)
+   PricingWorkers pricingWorkers_;
+
 public:
 
    // METHODS - Solutions, rotations, etc.
@@ -100,9 +221,9 @@ public:
    //                   ALREADY BE THERE !!!
    //
    // Shifts
-   inline void forbidShift(int k, int s){forbiddenShifts_.insert(pair<int,int>(k,s));}
+   inline void forbidShift(int k, int s){forbiddenShifts_.set(k,s);}
    inline void forbidShifts(set<pair<int,int> > shifts){ for(auto s : shifts) forbidShift(s.first, s.second);}
-   inline void authorizeShift(int k, int s){forbiddenShifts_.erase(pair<int,int>(k,s));}
+   inline void authorizeShift(int k, int s){forbiddenShifts_.reset(k,s);}
    inline void clearForbiddenShifts(){forbiddenShifts_.clear();}
    // Nurses
    inline void forbidNurse(int nurseId){forbiddenNursesIds_.insert(nurseId);}
@@ -110,9 +231,9 @@ public:
    inline void authorizeNurse(int nurseId){forbiddenNursesIds_.erase(nurseId);}
    inline void clearForbiddenNurses(){forbiddenNursesIds_.clear();}
    // Starting days
-   inline void forbidStartingDay(int k){forbiddenStartingDays_.insert(k);}
+   inline void forbidStartingDay(int k){forbiddenStartingDays_.set(k);}
    inline void forbidStartingDays(set<int> days){ for(auto d : days) forbidStartingDay(d);}
-   inline void authorizeStartingDay(int k){forbiddenStartingDays_.erase(k);}
+   inline void authorizeStartingDay(int k){forbiddenStartingDays_.reset(k);}
    inline void clearForbiddenStartingDays(){forbiddenStartingDays_.clear();}
    // Ending days
    inline void forbidEndingDay(int k){forbiddenEndingDays_.insert(k);}
@@ -121,9 +242,9 @@ public:
    inline void clearForbiddenEndingDays(){forbiddenEndingDays_.clear();}
 
    // Test functions
-   inline bool isShiftForbidden(int k, int n){ return (forbiddenShifts_.find(pair<int,int>(k,n)) != forbiddenShifts_.end()); }
+   inline bool isShiftForbidden(int k, int n){ return forbiddenShifts_.test(k,n); }
    inline bool isNurseForbidden(int n){ return (forbiddenNursesIds_.find(n) != forbiddenNursesIds_.end()); }
-   inline bool isStartingDayForbidden(int k){ return (forbiddenStartingDays_.find(k) != forbiddenStartingDays_.end()); }
+   inline bool isStartingDayForbidden(int k){ return forbiddenStartingDays_.test(k); }
    inline bool isEndingDayForbidden(int k){ return (forbiddenEndingDays_.find(k) != forbiddenEndingDays_.end()); }
 
 
@@ -140,18 +261,26 @@ protected:
 
 
 
-   //get the duals values per day and per shift for a nurse
+   //precompute the rows of the master whose dual values make up the dual costs of each nurse
    //
-   vector< vector<double> > getWorkDualValues(LiveNurse* pNurse);
-   vector<double> getStartWorkDualValues(LiveNurse* pNurse);
-   vector<double> getEndWorkDualValues(LiveNurse* pNurse);
-   double getWorkedWeekendDualValue(LiveNurse* pNurse);
+   void initDualRows();
 
    //compute some forbidden shifts from the lasts rotations and forbidden shifts
    void addForbiddenShifts();
 
-   // Retrieve the right subproblem
-   SubProblem* retriveSubproblem(LiveNurse*);
+   // Solve the subproblems of the nurses with the nbThreads_ pricing workers, which take the
+   // nurses one at a time. The rotations are added to the master in the order of the nurses by
+   // this thread, so the columns (and the early stop after nbSubProblemsToSolve_ successes) are
+   // the same as in the sequential loop. Return the minimum dual cost.
+   double pricingInParallel(double bound, vector<LiveNurse*>& nursesSolved);
+
+   // Price the rotations of the pool for a nurse. Return true if some rotations have been
+   // found, in which case they are stored in newRotationsForNurse_
+   bool priceFromColumnPool(LiveNurse* pNurse, DualCosts& dualCosts, const Tools::BitMatrix& forbiddenDayShifts,
+         double bound);
+
+   // Retrieve the right subproblem (each thread has its own subproblems)
+   SubProblem* retriveSubproblem(LiveNurse*, int thread = 0);
 
    // Add the rotations to the master problem
    void addRotationsToMaster();
@@ -170,6 +299,10 @@ protected:
    void print_current_solution_();
    void printStatSPSolutions();
 
+   // Write the statistics of the solve of a subproblem in the metrics file
+   void writeSubproblemMetrics(LiveNurse* pNurse, double time, int nLabelsCreated, int nLabelsDominated,
+         double bestReducedCost);
+
 
 
 
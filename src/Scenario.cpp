@@ -35,7 +35,7 @@ Scenario::Scenario(string name, int nbWeeks,
 		nbShifts_(nbShifts), intToShift_(intToShift), shiftToInt_(shiftToInt),
 		minConsShifts_(minConsShifts), maxConsShifts_(maxConsShifts),
 		nbForbiddenSuccessors_(nbForbiddenSuccessors), forbiddenSuccessors_(forbiddenSuccessors),
-		nbContracts_(nbContracts), intToContract_(intToContract), contracts_(contracts),
+		nbContracts_(nbContracts), intToContract_(intToContract), contracts_(contracts), ownsContracts_(true),
 		nbNurses_(nbNurses), theNurses_(theNurses), nurseNameToInt_(nurseNameToInt),
 		nbPositions_(0), nbShiftOffRequests_(0),
 		pWeekDemand_(0){
@@ -60,7 +60,7 @@ Scenario::Scenario(Scenario* pScenario,  vector<Nurse>& theNurses, Demand* pDema
 		nbShifts_(pScenario->nbShifts_), intToShift_(pScenario->intToShift_), shiftToInt_(pScenario->shiftToInt_),
 		minConsShifts_(pScenario->minConsShifts_), maxConsShifts_(pScenario->maxConsShifts_),
 		nbForbiddenSuccessors_(pScenario->nbForbiddenSuccessors_), forbiddenSuccessors_(pScenario->forbiddenSuccessors_),
-		nbContracts_(pScenario->nbContracts_), intToContract_(pScenario->intToContract_), contracts_(pScenario->contracts_),
+		nbContracts_(pScenario->nbContracts_), intToContract_(pScenario->intToContract_), contracts_(pScenario->contracts_), ownsContracts_(false),
 		nbNurses_(theNurses.size()), theNurses_(theNurses), nurseNameToInt_(pScenario->nurseNameToInt_),
 		thisWeek_(pScenario->thisWeek()), nbWeeksLoaded_(pScenario->nbWeeksLoaded()),
 		nbPositions_(0), nursesPerPosition_(0), nbShiftOffRequests_(0), pWeekDemand_(0){
@@ -83,7 +83,7 @@ nbSkills_(pScenario->nbSkills_), intToSkill_(pScenario->intToSkill_), skillToInt
 nbShifts_(pScenario->nbShifts_), intToShift_(pScenario->intToShift_), shiftToInt_(pScenario->shiftToInt_),
 minConsShifts_(pScenario->minConsShifts_), maxConsShifts_(pScenario->maxConsShifts_),
 nbForbiddenSuccessors_(pScenario->nbForbiddenSuccessors_), forbiddenSuccessors_(pScenario->forbiddenSuccessors_),
-nbContracts_(pScenario->nbContracts_), intToContract_(pScenario->intToContract_), contracts_(pScenario->contracts_),
+nbContracts_(pScenario->nbContracts_), intToContract_(pScenario->intToContract_), contracts_(pScenario->contracts_), ownsContracts_(false),
 nbNurses_(pScenario->nbNurses()), theNurses_(pScenario->theNurses_), nurseNameToInt_(pScenario->nurseNameToInt_),
 thisWeek_(pScenario->thisWeek()), nbWeeksLoaded_(pScenario->nbWeeksLoaded()),
 nbPositions_(0), nursesPerPosition_(0), nbShiftOffRequests_(0), pWeekDemand_(0) {
@@ -95,9 +95,11 @@ nbPositions_(0), nursesPerPosition_(0), nbShiftOffRequests_(0), pWeekDemand_(0)
 }
 
 Scenario::~Scenario(){
-	// delete the contracts
-	for(map<string,Contract*>::const_iterator itC = contracts_.begin(); itC != contracts_.end(); ++itC){
-		delete (itC->second);
+	// delete the contracts if they are not shared with another scenario
+	if (ownsContracts_) {
+		for(map<string,Contract*>::const_iterator itC = contracts_.begin(); itC != contracts_.end(); ++itC){
+			delete (itC->second);
+		}
 	}
   //delete pPositions_;
 	while (!pPositions_.empty()){
@@ -109,6 +109,11 @@ public:
 	const vector<string> intToContract_;
 	const map<string, Contract*> contracts_;
 
+	// only the scenario read from the input files owns the contracts, the copies
+	// share them and must not delete them
+	//
+	const bool ownsContracts_;
+
 	// number of nurses, and vector of all the nurses
 	//
 	const int nbNurses_;
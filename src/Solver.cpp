@@ -500,6 +500,7 @@ Solver::Solver(Scenario* pScenario, Demand* pDemand,
 	Preferences* pPreferences, vector<State>* pInitState):
 	pScenario_(pScenario),  pDemand_(pDemand),
 	pPreferences_(pPreferences), pInitState_(pInitState), pTimerTotal_(0),
+	pDeadline_(0), pParentDeadline_(0),
 	totalCostUnderStaffing_(-1), maxTotalStaffNoPenalty_(-1),
 	isPreprocessedSkills_(false), isPreprocessedNurses_(false), status_(UNSOLVED) {
 
@@ -542,6 +543,7 @@ Solver::~Solver(){
 	// kill the timer
 	pTimerTotal_->stop();
 	delete pTimerTotal_;
+	delete pDeadline_;
 
 	 for(LiveNurse* pNurse: theLiveNurses_)
 			delete pNurse;
@@ -799,7 +801,7 @@ void Solver::sortShuffleTheNurses() {
 
 	// shuffle the nurses that have the same position
 	for (int p=0; p < pScenario_->nbPositions(); p++) {
-		std::random_shuffle(nursePerPosition[p].begin(),nursePerPosition[p].end());
+		std::shuffle(nursePerPosition[p].begin(),nursePerPosition[p].end(),Tools::getRandomGenerator());
 	}
 
 	// fill the sorted vector of live nurses
@@ -15,6 +15,8 @@
 #include "Scenario.h"
 #include "SolverInput.h"
 
+#include <atomic>
+
 //-----------------------------------------------------------------------------
 //
 //  C l a s s   S t a t N u r s e C t
@@ -305,6 +307,26 @@ struct PrintSolution{
 	virtual void printCurrentSol() = 0;
 };
 
+//-----------------------------------------------------------------------------
+//
+//  S t r u c t u r e   S h a r e d I n c u m b e n t
+//    Incumbent shared by several branch and price trees exploring the same
+//    problem concurrently
+//
+//-----------------------------------------------------------------------------
+struct SharedIncumbent{
+	// best objective value found by any of the trees
+	std::atomic<double> ub_ {LARGE_SCORE};
+	// true as soon as one of the trees has completed its search
+	std::atomic<bool> isSearchOver_ {false};
+
+	// record the objective value of a new solution
+	void update(double ub) {
+		double current = ub_.load();
+		while (ub < current && !ub_.compare_exchange_weak(current, ub)) {}
+	}
+};
+
 //-----------------------------------------------------------------------------
 //
 //  C l a s s   S o l v e r P a r a m
@@ -328,13 +350,19 @@ public:
 
 	//maximal solving time in s
 	int maxSolvingTimeSeconds_ = LARGE_TIME;
+	// deadline of the calling process: the solver never runs after it (none if null)
+	const Tools::Deadline* pDeadline_ = 0;
 
 	//print parameters
 	bool printEverySolution_ = false;
 	string outfile_ = "outfiles/";
 	string logfile_ = "";
+	// machine-readable metrics of the column generation (one JSON object per line), not written if empty
+	string metricsfile_ = "";
 	vector<int> weekIndices_ = {};
 	PrintSolution* saveFunction_ = 0;
+	// incumbent shared with the other trees solving the same problem (none if null)
+	SharedIncumbent* sharedIncumbent_ = 0;
 
 	int verbose_ = 0;
 	bool printRelaxationSol_ = false;
@@ -368,6 +396,14 @@ public:
 
 	bool solveToOptimality_ = false;
 
+	// strong branching on the resting arcs: number of candidates evaluated by
+	// solving the LP of their children from the current basis (0 = no strong branching),
+	// maximum number of simplex iterations per child, and number of evaluations
+	// of a (nurse, day) after which its pseudo-costs are used instead
+	int strongBranchingNbCandidates_ = 0;
+	int strongBranchingMaxIterations_ = 50;
+	int strongBranchingReliability_ = 4;
+
 	//stop the algorithm after finding X solutions
 	//if 0, the algorithm computes the relaxation if the algorithm is a column generation procedure
 	int stopAfterXSolution_ = 5;
@@ -394,6 +430,10 @@ public:
 	// fathom a node is upper bound is smaller than the lagrangian bound
 	bool isLagrangianFathom_=true;
 
+	// warm start the first LP of a solve (e.g., the next window of the rolling
+	// horizon) with the basis and the basic columns of the last root LP
+	bool isLpWarmStart_ = true;
+
 
 	/* PARAMETERS OF THE PRICER */
 
@@ -413,6 +453,22 @@ public:
 	bool sp_withsecondchance_ = false;
 	double sp_max_reduced_cost_bound_ = 0.0;
 
+	// number of threads used to solve the subproblems of several nurses at the same time
+	// (1 = sequential pricing)
+	int sp_nbthreads_ = 1;
+
+	// price the long rotations with the layered label-setting algorithm instead
+	// of boost r_c_shortest_paths
+	bool sp_layered_labeling_ = false;
+
+	// price the long rotations with the bidirectional label-setting algorithm (labels
+	// from the source and from the sinks, joined on the half-way day)
+	bool sp_bidirectional_labeling_ = false;
+
+	// maximum number of rotations stored per nurse in the column pool of the pricer
+	// (0 = no column pool)
+	int sp_column_pool_size_ = 0;
+
 public:
 	// Initialize all the parameters according to a small number of options that
 	// represent the strategies we want to test
@@ -502,6 +558,11 @@ protected:
 	// Timer started at the creation of the solver and stopped at destruction
 	Tools::Timer* pTimerTotal_;
 
+	// Wall-clock deadline of the current solution process, carved from the
+	// deadline of the calling process if any
+	Tools::Deadline* pDeadline_;
+	const Tools::Deadline* pParentDeadline_;
+
 	//-----------------------------------------------------------------------------
 	// Manipulated data
 	//-----------------------------------------------------------------------------
@@ -618,6 +679,10 @@ public:
 	// It is a priori the same as a regular, but it might be modified if needed
 	virtual double LNSSolve(SolverParam parameters) {return 0.0;}
 
+	// Load the input solution in a new solver, so that it can be used as the current solution
+	// of LNSSolve (used by the parallel LNS)
+	virtual void LNSInitialize(SolverParam parameters, vector<Roster> solution) {}
+
 	// Solve the problem using a decomposition of the set nurses by connex components
 	// of the graph of positions
 	virtual double solveByConnexPositions() {return 0.0;}
@@ -765,6 +830,16 @@ public:
 	//
 	Tools::Timer* getTimerTotal() {return pTimerTotal_;}
 
+	// start a new deadline in timeLimit seconds, or at the parent deadline if
+	// it comes first
+	//
+	void setParentDeadline(const Tools::Deadline* pParent) {pParentDeadline_ = pParent;}
+	void startDeadline(double timeLimit) {
+		delete pDeadline_;
+		pDeadline_ = new Tools::Deadline(timeLimit, pParentDeadline_);
+	}
+	const Tools::Deadline* getDeadline() {return pDeadline_;}
+
 	// return the solution, but only for the k first days
 	//
 	vector<Roster> getSolutionAtDay(int k);
@@ -11,6 +11,9 @@
 #include "MasterProblem.h"
 #include "ReadWrite.h"
 
+#include <thread>
+#include <exception>
+
 // #define COMPARE_EVALUATIONS
 
 /******************************************************************************
@@ -204,6 +207,12 @@ StochasticSolver::~StochasticSolver(){
 // Main function
 double StochasticSolver::solve(vector<Roster> initialSolution){
 
+   // wall-clock deadline of the week: the solutions of the generation and
+   // evaluation problems carve their time limit from it
+   startDeadline(options_.totalTimeLimitSeconds_);
+   options_.generationParameters_.pDeadline_ = pDeadline_;
+   options_.evaluationParameters_.pDeadline_ = pDeadline_;
+
    options_.nExtraDaysGenerationDemands_ = std::min(options_.nExtraDaysGenerationDemands_,7*(pScenario_->nbWeeks()-(pScenario_->thisWeek()+1)));
    options_.nDaysEvaluation_ = std::min(options_.nDaysEvaluation_, 7*(pScenario_->nbWeeks()-(pScenario_->thisWeek()+1)));
    // Special case of the last week -> always to optimality with no time limit
@@ -296,7 +305,7 @@ void StochasticSolver::solveOneWeekGenerationEvaluation(){
    while(nSchedules_<options_.nGenerationDemandsMax_){
 
       // get the time left to solve another schedule
-      double timeLeft = options_.totalTimeLimitSeconds_ - pTimerTotal_->dSinceInit();
+      double timeLeft = pDeadline_->remaining();
       if (nSchedules_ > 0) {
          if (timeLeft < 1.0) break;
          //			options_.generationParameters_.maxSolvingTimeSeconds_  = (timeLeft-1.0)/2.0;
@@ -387,7 +396,7 @@ void StochasticSolver::solveIterativelyWithIncreasingDemand() {
    options_.generationCostPerturbation_ = true;
 
    // Initialize the values that intervene in the stopping criterion
-   double timeLeft = options_.totalTimeLimitSeconds_-pTimerTotal_->dSinceInit();
+   double timeLeft = pDeadline_->remaining();
    Tools::Timer* timerSolve = new Tools::Timer();
    timerSolve->init();
    double timeLastSolve = 0.0;
@@ -415,7 +424,7 @@ void StochasticSolver::solveIterativelyWithIncreasingDemand() {
             solveOneWeekNoGenerationEvaluation();
          }
          // Go back to the last solution if the solver was interrupted
-         timeLeft = options_.totalTimeLimitSeconds_-pTimerTotal_->dSinceInit();
+         timeLeft = pDeadline_->remaining();
          if (timeLeft <= 1.0) {
             (*pLogStream_) << "# The execution had to be interrupted, so the solution is not kept" << std::endl;
             loadSolution(previousSolution);
@@ -694,10 +703,18 @@ bool StochasticSolver::evaluateSchedule(int sched){
    // double timeLeft = options_.totalTimeLimitSeconds_-pTimerTotal_->dSinceInit();
    // options_.evaluationParameters_.maxSolvingTimeSeconds_ = (timeLeft-1.0)/(double)options_.nEvaluationDemands_;
 
+   // The evaluation of demand j draws from its own stream, derived from a master seed drawn once per schedule,
+   // so that the evaluation does not depend on the number of evaluation threads
+   int masterSeed = Tools::getRandomGenerator()();
+
+#ifndef COMPARE_EVALUATIONS
+   if(options_.nEvaluationThreads_ > 1)
+      return evaluateScheduleInParallel(sched, initialStates, baseCost, masterSeed);
+#endif
 
    for(int j=0; j<options_.nEvaluationDemands_; j++){
 
-      double timeLeft = options_.totalTimeLimitSeconds_ - pTimerTotal_->dSinceInit();
+      double timeLeft = pDeadline_->remaining();
       if (nSchedules_ > 0)
          if (timeLeft < 1.0){
             cout << "# Time has run out when evaluating schedule no." << (nSchedules_-1) << endl;
@@ -744,11 +761,14 @@ bool StochasticSolver::evaluateSchedule(int sched){
       else {
          // Perform the actual evaluation on demand j by running the chosen algorithm
          // TODO : ici, arondi a l'entier -> peut etre modifie si besoin
+         std::minstd_rand masterStream = Tools::getRandomGenerator();
+         Tools::initializeRandomStream(Tools::getStreamSeed(masterSeed, j));
          if(j==0){
             currentCost += (int) pReusableEvaluationSolvers_[sched]->solve(options_.evaluationParameters_);
          } else {
             currentCost += (int) pReusableEvaluationSolvers_[sched]->resolve(pEvaluationDemands_[j], options_.evaluationParameters_);
          }
+         Tools::getRandomGenerator() = masterStream;
 
 #ifdef COMPARE_EVALUATIONS
          pGreedyEvaluators[j]->solve();
@@ -762,15 +782,7 @@ bool StochasticSolver::evaluateSchedule(int sched){
 
       // Insert the solution cost and solution
       //
-      // If already in the costs -> add it to the set of schedules that found that cost
-      if(schedulesFromObjectiveByEvaluationDemand_[j].find(currentCost) != schedulesFromObjectiveByEvaluationDemand_[j].end()){
-         schedulesFromObjectiveByEvaluationDemand_[j].at(currentCost).insert(sched);
-      }
-      // Otherwise, add a new pair
-      else{
-         set<int> s; s.insert(sched);
-         schedulesFromObjectiveByEvaluationDemand_[j].insert(pair<double, set<int> >( currentCost, s));
-      }
+      recordEvaluationCost(sched, j, currentCost);
 #ifdef COMPARE_EVALUATIONS
       if(schedulesFromObjectiveByEvaluationDemandGreedy_[j].find(currentCostGreedy) != schedulesFromObjectiveByEvaluationDemandGreedy_[j].end()){
          schedulesFromObjectiveByEvaluationDemandGreedy_[j].at(currentCostGreedy).insert(sched);
@@ -790,6 +802,97 @@ bool StochasticSolver::evaluateSchedule(int sched){
 
 }
 
+// Evaluate 1 schedule on all evaluation instances, by batches of nEvaluationThreads_ demands
+// Each demand of a batch is solved by its own solver in its own thread. The solvers are built
+// and perturbed in the main thread, and the costs are merged once the whole batch is solved.
+bool StochasticSolver::evaluateScheduleInParallel(int sched, vector<State>& initialStates, int baseCost, int masterSeed){
+
+   for(int j0=0; j0<options_.nEvaluationDemands_; j0+=options_.nEvaluationThreads_){
+
+      double timeLeft = pDeadline_->remaining();
+      if (nSchedules_ > 0)
+         if (timeLeft < 1.0){
+            cout << "# Time has run out when evaluating schedule no." << (nSchedules_-1) << endl;
+            return false;
+         }
+
+      int j1 = min(j0+options_.nEvaluationThreads_, options_.nEvaluationDemands_);
+      (*pLogStream_) << "# [week=" << pScenario_->thisWeek() << "] Starting evaluation of schedule no. " << sched << " over evaluation demands no. " << j0 << " to " << j1-1 << std::endl;
+
+      // Build the solvers of the batch
+      //
+      vector<Solver*> pSolvers;
+      for(int j=j0; j<j1; j++){
+         Solver* pSolver = setEvaluationWithInputAlgorithm(pEvaluationDemands_[j], & initialStates);
+         if(options_.evaluationCostPerturbation_)
+            if(pSolver->getNbDays() + (7*pScenario_->thisWeek()+1) < 7* pScenario_->nbWeeks_)
+               pSolver->setBoundsAndWeights(options_.evaluationParameters_.weightStrategy_);
+         pSolvers.push_back(pSolver);
+      }
+
+      // Solve them concurrently
+      //
+      vector<double> costs (j1-j0, costPreviousWeeks_ + baseCost);
+      vector<std::exception_ptr> errors (j1-j0);
+      if (pReusableGenerationSolver_->getStatus() == INFEASIBLE) {
+         for(double& cost: costs) cost = 1.0e6;
+      }
+      else {
+         vector<std::thread> threads;
+         for(int i=0; i<j1-j0; i++){
+            // the seed depends on the demand, not on its position in the batch
+            int seed = Tools::getStreamSeed(masterSeed, j0+i);
+            threads.push_back(std::thread([this, i, seed, &pSolvers, &costs, &errors](){
+               try{
+                  Tools::initializeRandomStream(seed);
+                  costs[i] += (int) pSolvers[i]->solve(options_.evaluationParameters_);
+               }
+               catch(...){
+                  errors[i] = std::current_exception();
+               }
+            }));
+         }
+         for(std::thread& t: threads) t.join();
+      }
+
+      // Keep the solver of the first demand as the one of the schedule and delete the others
+      // (before any rethrow, so that no solver of the batch is leaked)
+      //
+      for(int j=j0; j<j1; j++){
+         if(j == 0) pReusableEvaluationSolvers_[sched] = pSolvers[0];
+         else delete pSolvers[j-j0];
+      }
+      for(std::exception_ptr& e: errors)
+         if(e) std::rethrow_exception(e);
+
+      // Record the costs in the order of the demands
+      //
+      for(int j=j0; j<j1; j++){
+         (*pLogStream_) << "# [week=" << pScenario_->thisWeek() << "] Schedule no. " << sched << " evaluated over evaluation demand no. " << j << " (solution cost: " << costs[j-j0] << ")." << std::endl;
+         recordEvaluationCost(sched, j, costs[j-j0]);
+      }
+   }
+
+   (*pLogStream_) << "# Evaluation of schedule no. " << sched << " done!" << std::endl;
+
+   updateRankingsAndScores(options_.rankingStrategy_);
+
+   return true;
+}
+
+// Insert the cost obtained by the schedule sched on the evaluation demand j
+void StochasticSolver::recordEvaluationCost(int sched, int j, double cost){
+   // If already in the costs -> add it to the set of schedules that found that cost
+   if(schedulesFromObjectiveByEvaluationDemand_[j].find(cost) != schedulesFromObjectiveByEvaluationDemand_[j].end()){
+      schedulesFromObjectiveByEvaluationDemand_[j].at(cost).insert(sched);
+   }
+   // Otherwise, add a new pair
+   else{
+      set<int> s; s.insert(sched);
+      schedulesFromObjectiveByEvaluationDemand_[j].insert(pair<double, set<int> >( cost, s));
+   }
+}
+
 // Recompute all scores after one schedule evaluation
 void StochasticSolver::updateRankingsAndScores(RankingStrategy strategy){
    (*pLogStream_) << "# [week=" << pScenario_->thisWeek() << "] Starting the update of the scores and ranking." << std::endl;
@@ -75,6 +75,10 @@ public:
 	int nDaysEvaluation_ = 14;
 	int nGenerationDemandsMax_ = 100;
 
+	// Number of evaluation demands solved concurrently when evaluating a schedule (each on its own solver)
+	// WARNING: if >1, the evaluation solvers cannot be warm-started from the previous evaluation demand
+	int nEvaluationThreads_ = 1;
+
 	string logfile_ = "";
 
 	SolverParam generationParameters_;
@@ -247,6 +251,10 @@ protected:
 	void initScheduleEvaluation(int sched);
 	// Evaluate 1 schedule and store the corresponding detailed results (returns false if time has run out)
 	bool evaluateSchedule(int sched);
+	// Same, but solves the evaluation demands by batches of nEvaluationThreads_ concurrent solvers
+	bool evaluateScheduleInParallel(int sched, vector<State>& initialStates, int baseCost, int masterSeed);
+	// Insert the cost obtained by the schedule sched on the evaluation demand j
+	void recordEvaluationCost(int sched, int j, double cost);
 	// Recompute all scores after one schedule evaluation
 	void updateRankingsAndScores(RankingStrategy strategy);
 	// Getter
@@ -19,6 +19,10 @@
 using std::stringstream;
 using std::vector;
 
+// Solves each subproblem with the forward labeling too when the bidirectional one is selected, and stops if the two
+// algorithms do not return the same rotations
+// #define COMPARE_LABELINGS
+
 
 
 /////////////////////////////////////////////////
@@ -70,6 +74,10 @@ SubProblem::SubProblem(Scenario * scenario, int nbDays, const Contract * contrac
 
 	createNodes();
 	createArcs();
+	initCompactGraph();
+	initTopologicalOrder();
+	initNodeDays();
+	initArcCostTables();
 
 	// Set all arc and node status to authorized
 	for(int v=0; v<nNodes_; v++) nodeStatus_.push_back(true);
@@ -81,6 +89,8 @@ SubProblem::SubProblem(Scenario * scenario, int nbDays, const Contract * contrac
 		dayShiftStatus_.push_back(v);
 	}
 	for(int k=0; k<nDays_; k++) startingDayStatus_.push_back(true);
+	appliedForbiddenDayShifts_ = Tools::BitMatrix(nDays_, pScenario_->nbShifts_);
+	appliedForbiddenStartingDays_ = Tools::BitMatrix(nDays_);
 
 	nPathsMin_ = 0;
 
@@ -94,6 +104,71 @@ SubProblem::SubProblem(Scenario * scenario, int nbDays, const Contract * contrac
 
 }
 
+// Copies the graph of the skeleton. The edge descriptors point to the properties of the
+// arcs of the skeleton, so they must be retrieved from the new graph.
+SubProblem::SubProblem(Scenario* scenario, const Contract* contract, const SubProblem& skeleton) {
+	*this = skeleton;
+	pScenario_ = scenario;
+	pContract_ = contract;
+
+	boost::graph_traits<Graph>::edge_iterator eIt, eEnd;
+	for(boost::tie(eIt, eEnd) = edges(g_); eIt != eEnd; ++eIt)
+		arcsDescriptors_[g_[*eIt].num] = *eIt;
+
+	timeInS_ = new Tools::Timer(); timeInS_->init();
+	timeInNL_ = new Tools::Timer(); timeInNL_->init();
+}
+
+std::mutex SubProblem::s_skeletonsMutex;
+map<string, std::shared_ptr<const SubProblem> > SubProblem::s_skeletons;
+std::deque<string> SubProblem::s_skeletonsOrder;
+
+SubProblem* SubProblem::buildFromCache(Scenario* scenario, int nbDays, const Contract* contract, vector<State>* pInitState){
+	int maxOngoingDaysWorked = 0;
+	for(const State& state: *pInitState)
+		maxOngoingDaysWorked = max(state.consDaysWorked_, maxOngoingDaysWorked);
+
+	std::stringstream key;
+	key << scenario->name_ << "|" << contract->name_ << "|" << nbDays << "|" << maxOngoingDaysWorked;
+
+	// Look for the skeleton
+	//
+	std::shared_ptr<const SubProblem> pSkeleton;
+	{
+		std::lock_guard<std::mutex> lock(s_skeletonsMutex);
+		map<string, std::shared_ptr<const SubProblem> >::iterator it = s_skeletons.find(key.str());
+		if(it != s_skeletons.end()) pSkeleton = it->second;
+	}
+
+	// Build it if needed (outside of the lock, so that the skeletons of different contracts are built concurrently).
+	// If another thread has built the same skeleton in the meantime, its skeleton is kept.
+	//
+	if(!pSkeleton){
+		std::shared_ptr<const SubProblem> pNewSkeleton (new SubProblem(scenario, nbDays, contract, pInitState));
+		std::lock_guard<std::mutex> lock(s_skeletonsMutex);
+		pair<map<string, std::shared_ptr<const SubProblem> >::iterator, bool> ins =
+			s_skeletons.insert(pair<string, std::shared_ptr<const SubProblem> >(key.str(), pNewSkeleton));
+		pSkeleton = ins.first->second;
+		if(ins.second){
+			s_skeletonsOrder.push_back(key.str());
+			while(s_skeletonsOrder.size() > MAX_NB_SKELETONS){
+				s_skeletons.erase(s_skeletonsOrder.front());
+				s_skeletonsOrder.pop_front();
+			}
+		}
+	}
+
+	// The skeletons are never modified once in the cache, so they can be copied concurrently
+	//
+	return new SubProblem(scenario, contract, *pSkeleton);
+}
+
+void SubProblem::clearSkeletonCache(){
+	std::lock_guard<std::mutex> lock(s_skeletonsMutex);
+	s_skeletons.clear();
+	s_skeletonsOrder.clear();
+}
+
 SubProblem::~SubProblem(){}
 
 // Initialization function
@@ -154,10 +229,11 @@ void SubProblem::initShortSuccessions(){
 
 	// Put an empty list of size 0 for all data because there exists no succession of length 0/
 	//
-	vector2D v2; vector<int> v1,v1bis; vector<double> vd1;
+	vector2D v2; vector<int> v1,v1bis,v1ter; vector<double> vd1;
 	allowedShortSuccBySize_.push_back(v2);
 	lastShiftOfShortSucc_.push_back(v1);
 	nLastShiftOfShortSucc_.push_back(v1bis);
+	parentOfShortSucc_.push_back(v1ter);
 	baseArcCostOfShortSucc_.push_back(vd1);
 
 	// Initialize the other way round
@@ -178,6 +254,7 @@ void SubProblem::initShortSuccessions(){
 		vector2D allSuccSizeC;
 		vector<int> lastShiftSucc;
 		vector<int> nLastShiftSucc;
+		vector<int> parentSucc;
 		vector<double> arcCostSucc;
 
 		// Compute new succession
@@ -191,6 +268,7 @@ void SubProblem::initShortSuccessions(){
 				allSuccSizeC.push_back(shiftSuccession);						// Add it to the possibilities
 				lastShiftSucc.push_back(s);										// Record its last shift
 				nLastShiftSucc.push_back(1);									// Only 1 successive performed so far
+				parentSucc.push_back(-1);										// No shorter succession
 				arcCostSucc.push_back(0);										// No succession ended yet
 			}
 		}
@@ -211,6 +289,7 @@ void SubProblem::initShortSuccessions(){
 						vector<int> newSucc (succ); newSucc.push_back(newSh);		// Create Succession
 						allSuccSizeC.push_back(newSucc);							// Add it to the possibilities
 						lastShiftSucc.push_back(newSh);								// Record its last shift
+						parentSucc.push_back(i);									// Record the succession it extends
 						if (newSh == lastSh){										// Depending on the previous one, update number of consecutive and cost
 							nLastShiftSucc.push_back(nLast+1);
 							arcCostSucc.push_back(cost);
@@ -240,6 +319,7 @@ void SubProblem::initShortSuccessions(){
 						vector<int> newSucc (succ); newSucc.push_back(newSh);		// Create Succession
 						allSuccSizeC.push_back(newSucc);							// Add it to the possibilities
 						lastShiftSucc.push_back(newSh);								// Record its last shift
+						parentSucc.push_back(i);									// Record the succession it extends
 						int newNLast = 1;
 						double newCost = cost;
 						if(newSh == lastSh){	// BUT : add the cost if longer than the maximum allowed
@@ -268,6 +348,7 @@ void SubProblem::initShortSuccessions(){
 		allowedShortSuccBySize_.push_back(allSuccSizeC);
 		lastShiftOfShortSucc_.push_back(lastShiftSucc);
 		nLastShiftOfShortSucc_.push_back(nLastShiftSucc);
+		parentOfShortSucc_.push_back(parentSucc);
 		baseArcCostOfShortSucc_.push_back(arcCostSucc);
 
 	}
@@ -299,8 +380,9 @@ double SubProblem::consDaysCost(int n){
 //--------------------------------------------
 
 // Solve : Returns TRUE if negative reduced costs path were found; FALSE otherwise.
-bool SubProblem::solve(LiveNurse* nurse, DualCosts * costs, SubproblemParam param, set<pair<int,int> > forbiddenDayShifts,
-		set<int> forbiddenStartingDays, bool optimality, double redCostBound){
+bool SubProblem::solve(LiveNurse* nurse, DualCosts * costs, SubproblemParam param,
+		const Tools::BitMatrix& forbiddenDayShifts, const Tools::BitMatrix& forbiddenStartingDays, bool optimality,
+		double redCostBound){
 
 
 	bestReducedCost_ = 0;
@@ -323,8 +405,10 @@ bool SubProblem::solve(LiveNurse* nurse, DualCosts * costs, SubproblemParam para
 	initStructuresForSolve();								// Initialize structures
 	nLongFound_=0;											// Initialize number of solutions found at 0 (long rotations)
 	nVeryShortFound_=0;										// Initialize number of solutions found at 0 (short rotations)
-	forbid(forbiddenDayShifts);								// Forbid arcs
-	forbidStartingDays(forbiddenStartingDays);				// Forbid starting days
+	nLabelsCreated_=0;										// Initialize the label counters
+	nLabelsDominated_=0;
+	updateForbiddenDayShifts(forbiddenDayShifts);			// Forbid nodes (only the changes since the last solve)
+	updateForbiddenStartingDays(forbiddenStartingDays);		// Forbid starting days (idem)
 
 	if(false) printContractAndPrefenrences();				// Set to true if you want to display contract + preferences (for debug)
 
@@ -335,10 +419,6 @@ bool SubProblem::solve(LiveNurse* nurse, DualCosts * costs, SubproblemParam para
 	bool ANS_long = solveLongRotations(optimality);
 	timeInNL_->stop();
 
-	// Reset authorizations
-	authorize(forbiddenDayShifts);
-	authorizeStartingDays(forbiddenStartingDays);
-
 	return ANS_short or ANS_long;
 }
 
@@ -395,6 +475,21 @@ bool SubProblem::solveLongRotations(bool optimality){
 // Function called when optimal=true in the arguments of solve -> shortest path problem is to be solved
 bool SubProblem::solveLongRotationsOptimal(){
 
+	// BIDIRECTIONAL OR LAYERED LABEL-SETTING INSTEAD OF BOOST
+	//
+	if(param_.bidirectionalLabeling_){
+#ifdef COMPARE_LABELINGS
+		compareLabelings();
+#endif
+		return solveLongRotationsBidirectional();
+	}
+	if(param_.layeredLabeling_)
+		return solveLongRotationsLayered();
+
+	// The boost algorithms work on g_: copy the current costs and resource windows
+	//
+	updateBoostGraph();
+
 	vector< vector< boost::graph_traits<Graph>::edge_descriptor> > opt_solutions_spptw;
 	vector<spp_spptw_res_cont> pareto_opt_rcs_spptw;
 
@@ -413,7 +508,7 @@ bool SubProblem::solveLongRotationsOptimal(){
 				ref_spptw(),
 				dominance_spptw(),
 				std::allocator< boost::r_c_shortest_paths_label< Graph, spp_spptw_res_cont> >(),
-				boost::default_r_c_shortest_paths_visitor() );
+				counting_visitor_spptw(&nLabelsCreated_, &nLabelsDominated_) );
 		return addRotationsFromPaths(opt_solutions_spptw, pareto_opt_rcs_spptw);
 	}
 
@@ -436,7 +531,7 @@ bool SubProblem::solveLongRotationsOptimal(){
 				ref_spptw(),
 				dominance_spptw(),
 				std::allocator< boost::r_c_shortest_paths_label< Graph, spp_spptw_res_cont> >(),
-				boost::default_r_c_shortest_paths_visitor() );
+				counting_visitor_spptw(&nLabelsCreated_, &nLabelsDominated_) );
 		return addRotationsFromPaths(opt_solutions_spptw, pareto_opt_rcs_spptw);
 	}
 }
@@ -500,21 +595,30 @@ bool SubProblem::addRotationsFromPaths(vector< vector< boost::graph_traits<Graph
 // Adds a rotation made from the given path to the current list of answers and increases their counter
 //
 Rotation SubProblem::rotationFromPath(vector< boost::graph_traits<Graph>::edge_descriptor > path, spp_spptw_res_cont resource){
+	vector<int> arcs;
+	for(boost::graph_traits<Graph>::edge_descriptor e: path)
+		arcs.push_back( boost::get(&Arc_Properties::num, g_, e) );
+	return rotationFromArcs(arcs, resource.cost);
+}
+
+// Returns the rotation made from the given arcs (from the last to the first one)
+//
+Rotation SubProblem::rotationFromArcs(const vector<int>& arcs, double cost){
 
 	int firstDay = -1;
 	vector<int> shiftSuccession;
 
 	// All arcs are consecutively considered
 	//
-	for( int j = static_cast<int>( path.size() ) - 1; j >= 0;	--j){
-		int a = boost::get(&Arc_Properties::num, g_, path[j]);
+	for( int j = static_cast<int>( arcs.size() ) - 1; j >= 0;	--j){
+		int a = arcs[j];
 		ArcType aType = arcType(a);
-		int destin = boost::target( path[j], g_ );
+		int destin = arcDestination(a);
 
 		// A. Arc from source (equivalent to short rotation
 		if(aType == SOURCE_TO_PRINCIPAL){
 			firstDay =  principalToDay_[destin] - CDMin_ + 1;
-			for(int s: static_cast<vector <int> >( allowedShortSuccBySize_[CDMin_][ shortSuccCDMinIdFromArc_.at(a) ] )){
+			for(int s: allowedShortSuccBySize_[CDMin_][ shortSuccCDMinIdFromArc_.at(a) ]){
 				shiftSuccession.push_back(s);
 			}
 		}
@@ -525,7 +629,7 @@ Rotation SubProblem::rotationFromPath(vector< boost::graph_traits<Graph>::edge_d
 		}
 	}
 
-	Rotation rot (firstDay, shiftSuccession, pLiveNurse_->id_, MAX_COST, resource.cost);
+	Rotation rot (firstDay, shiftSuccession, pLiveNurse_->id_, MAX_COST, cost);
 	return rot;
 }
 
@@ -576,12 +680,12 @@ void SubProblem::createNodes(){
 	for(int k=0; k<nDays_; k++){
 		rotationLengthEntrance_.push_back(nNodes_);									// One node for the entrance in subnetwork per day
 		addSingleNode(ROTATION_LENGTH_ENTRANCE, 0, maxRotationLength_);
-		map<int,int> checkNodesForThatDay;
+		vector<int> checkNodesForThatDay;
 		// Check nodes
 		for(int l=CD_max; l<=maxRotationLength_; l++){								// Check nodes: from CD_max (longest free) to maximum rotation length, for each day
-			checkNodesForThatDay.insert(pair<int,int>(l,nNodes_));
-			rotationLengthNodesLAT_.insert(pair<int,int>(nNodes_,l));
+			checkNodesForThatDay.push_back(nNodes_);
 			addSingleNode(ROTATION_LENGTH, 0, l);
+			rotationLengthNodesLAT_[nNodes_-1] = l;
 		}
 		rotationLengthNodes_.push_back(checkNodesForThatDay);
 		// Sink day
@@ -612,6 +716,8 @@ void SubProblem::initNodesStructures(){
 	rotationLengthNodes_.clear();
 	rotationLengthNodesLAT_.clear();
 	sinkNodesByDay_.clear();
+	nodeEat_.clear();
+	nodeLat_.clear();
 
 	// All nodes
 	//
@@ -639,6 +745,12 @@ void SubProblem::initNodesStructures(){
 void SubProblem::addSingleNode(NodeType type, int eat, int lat){
 	add_vertex( Vertex_Properties( nNodes_, type, eat, lat ), g_ );
 	allNodesTypes_.push_back(type);
+	nodeEat_.push_back(eat);
+	nodeLat_.push_back(lat);
+	principalToShift_.push_back(-1);
+	principalToDay_.push_back(-1);
+	principalToCons_.push_back(-1);
+	rotationLengthNodesLAT_.push_back(-1);
 	nNodes_++;
 
 }
@@ -648,18 +760,17 @@ void SubProblem::addNodeToPrincipalNetwork(int sh, int k, int cons){
 
 	// Store its ID in the vector3D
 	//
-	allNodesTypes_.push_back(PRINCIPAL_NETWORK);
 	principalNetworkNodes_[sh][k][cons] = nNodes_;
 
-	// Store the information backwards
-	//
-	principalToShift_.insert(pair<int,int>(nNodes_, sh));
-	principalToDay_.insert(pair<int,int>(nNodes_, k));
-	principalToCons_.insert(pair<int,int>(nNodes_, cons));
-
 	// Create the node
 	//
 	addSingleNode(PRINCIPAL_NETWORK, 0, maxRotationLength_);
+
+	// Store the information backwards
+	//
+	principalToShift_[nNodes_-1] = sh;
+	principalToDay_[nNodes_-1] = k;
+	principalToCons_[nNodes_-1] = cons;
 }
 
 
@@ -684,6 +795,10 @@ void SubProblem::addSingleArc(int o, int d, double baseCost, int t, ArcType type
 	arcsDescriptors_.push_back(e);
 	allArcsTypes_.push_back(type);
 	arcBaseCost_.push_back(baseCost);
+	arcOrigin_.push_back(o);
+	arcDestination_.push_back(d);
+	arcCost_.push_back(baseCost);
+	arcTime_.push_back(t);
 	nArcs_++;
 
 	if(nodeType(o) == PRINCIPAL_NETWORK
@@ -695,10 +810,39 @@ void SubProblem::addSingleArc(int o, int d, double baseCost, int t, ArcType type
 
 }
 
+// Builds the out arcs of each node (compressed sparse row), in the order of creation of the arcs
+void SubProblem::initCompactGraph(){
+	outArcsStart_.assign(nNodes_+1, 0);
+	for(int a=0; a<nArcs_; a++)
+		outArcsStart_[arcOrigin_[a]+1] ++;
+	for(int v=0; v<nNodes_; v++)
+		outArcsStart_[v+1] += outArcsStart_[v];
+
+	vector<int> next (outArcsStart_.begin(), outArcsStart_.end()-1);
+	outArcs_.assign(nArcs_, -1);
+	for(int a=0; a<nArcs_; a++)
+		outArcs_[next[arcOrigin_[a]]++] = a;
+}
+
+// Copies the costs, travel times and latest arrival times into the boost graph
+void SubProblem::updateBoostGraph(){
+	for(int a=0; a<nArcs_; a++){
+		Arc_Properties& arc_prop = g_[arcsDescriptors_[a]];
+		arc_prop.cost = arcCost_[a];
+		arc_prop.time = arcTime_[a];
+	}
+	for(int v=0; v<nNodes_; v++)
+		g_[v].lat = nodeLat_[v];
+}
+
 // Initializes the data structures used for the arcs
 void SubProblem::initArcsStructures(){
 	nArcs_ = 0;
 	vector< boost::graph_traits< Graph>::edge_descriptor > ve; arcsDescriptors_ = ve;
+	arcOrigin_.clear();
+	arcDestination_.clear();
+	arcCost_.clear();
+	arcTime_.clear();
 
 	// Initialization of info -> arcId data structures
 	arcsFromSource_.clear();
@@ -825,19 +969,20 @@ void SubProblem::createArcsAllRotationSize(){
 	//
 	for(int k=CDMin_-1; k<nDays_; k++){
 
-		map<int,int> rotLengthNodesForDay = rotationLengthNodes_[k];
+		const vector<int>& rotLengthNodesForDay = rotationLengthNodes_[k];
 		map<int,int> arcsRotsizeinToRotsize;
 		map<int,int> arcsRotsizeToRotsizeout;
-		for(map<int,int>::iterator itRLN = rotLengthNodesForDay.begin(); itRLN != rotLengthNodesForDay.end(); ++itRLN){
+		for(int i=0; i<rotLengthNodesForDay.size(); i++){
+			int l = pContract_->maxConsDaysWork_ + i;
 			// From entrance of that day to checknode
 			origin = rotationLengthEntrance_[k];
-			destin = itRLN->second;
-			arcsRotsizeinToRotsize.insert(pair<int,int>(itRLN->first, nArcs_));
-			addSingleArc(origin, destin, consDaysCost(itRLN->first), 0, ROTSIZEIN_TO_ROTSIZE);
+			destin = rotLengthNodesForDay[i];
+			arcsRotsizeinToRotsize.insert(pair<int,int>(l, nArcs_));
+			addSingleArc(origin, destin, consDaysCost(l), 0, ROTSIZEIN_TO_ROTSIZE);
 			// From checknode to exit of that day
-			origin = itRLN->second;
+			origin = rotLengthNodesForDay[i];
 			destin = sinkNodesByDay_[k];
-			arcsRotsizeToRotsizeout.insert(pair<int,int>( itRLN->first, nArcs_));
+			arcsRotsizeToRotsizeout.insert(pair<int,int>( l, nArcs_));
 			addSingleArc(origin, destin, 0, 0, ROTSIZE_TO_SINK);
 		}
 
@@ -911,23 +1056,46 @@ void SubProblem::priceShortSucc(){
 	map<int,int> specialArcsSuccId;
 	map<int,double> specialArcsCost;
 
+	// Costs and status of the days of the successions for every start date
+	updateShortSuccWindows();
+	const int nSuccCDMin = allowedShortSuccBySize_[CDMin_].size();
+	const vector<double>& baseCosts = baseArcCostOfShortSucc_[CDMin_];
+
 	for(int s=1; s<pScenario_->nbShifts_; s++){
 		for(int k=CDMin_-1; k<nDays_; k++){
+			const int startDate = k-CDMin_+1;
+
+			// Costs that only depend on the start date: complete weekend, worked weekends and first day
+			double startDateCost = startWeekendCosts_[startDate]
+				- Tools::containsWeekend(startDate, k) * pCosts_->workedWeekendCost()
+				- pCosts_->startWorkCost(startDate);
+
 			for(int n=1; n<=maxvalConsByShift_[s]; n++){
 
 				idBestShortSuccCDMin_[s][k][n] = -1;
 				arcCostBestShortSuccCDMin_[s][k][n] = MAX_COST;
 
 				// CHECK THE ROTATIONS ONLY IF THE FIRST DAY IS ALLOWED
-				if(startingDayStatus_[k-CDMin_+1]){
+				if(startingDayStatus_[startDate]){
 
-					for(int i=0; i<(allShortSuccCDMinByLastShiftCons_[s][n]).size(); i++){
-						int curSuccId = allShortSuccCDMinByLastShiftCons_[s][n][i];
-						vector<int> succ = allowedShortSuccBySize_[CDMin_][curSuccId];
+					const vector<int>& succIds = allShortSuccCDMinByLastShiftCons_[s][n];
+					for(int curSuccId: succIds){
 
 						// SUCCESSION IS TAKEN INTO ACCOUNT ONLY IF IT DOES NOT VIOLATE ANY FORBIDDEN DAY-SHIFT COUPLE
-						if(canSuccStartHere( succ, k-CDMin_+1 )){
-							double curCost = costArcShortSucc(CDMin_, curSuccId, k-CDMin_+1);
+						// The first day depends on the initial state and is priced from scratch
+						bool isValid;
+						double curCost = MAX_COST;
+						if(startDate == 0){
+							isValid = canSuccStartHere( allowedShortSuccBySize_[CDMin_][curSuccId], 0 );
+							if(isValid) curCost = costArcShortSucc(CDMin_, curSuccId, 0);
+						}
+						else {
+							int index = startDate*nSuccCDMin + curSuccId;
+							isValid = windowStatusShortSuccCDMin_[index];
+							curCost = baseCosts[curSuccId] + startDateCost + windowCostShortSuccCDMin_[index];
+						}
+
+						if(isValid){
 
 							// ONLY CASE WHEN THE DESTINATION NODE MAY HAVE TO CHANGE:
 							// 1. Start date is 0
@@ -980,6 +1148,81 @@ void SubProblem::priceShortSucc(){
 	}
 }
 
+// Updates the sum of the costs (preference - dual) and the status of the days of every short
+// succession of size CDMin for every start date d>0. Each succession of size c extends one of size
+// c-1, so a DP on the sizes computes the sums of all the successions starting on a date with one
+// addition per succession and size. Only the start dates whose days have a day-shift whose cost
+// or status changed since the last call are evaluated again.
+//
+void SubProblem::updateShortSuccWindows(){
+	const int nShifts = pScenario_->nbShifts_;
+	const int nSuccCDMin = allowedShortSuccBySize_[CDMin_].size();
+	const int nStartDates = nDays_-CDMin_+1;
+	if(nStartDates <= 1) return;
+
+	if(!isShortSuccWindowInit_){
+		windowCostShortSuccCDMin_.assign(nStartDates*nSuccCDMin, 0.0);
+		windowStatusShortSuccCDMin_.assign(nStartDates*nSuccCDMin, 0);
+		lastDayShiftCost_.assign(nDays_*nShifts, 0.0);
+		lastDayShiftStatus_.assign(nDays_*nShifts, 0);
+		prefixCostShortSucc_.resize(CDMin_+1);
+		prefixStatusShortSucc_.resize(CDMin_+1);
+		for(int c=1; c<=CDMin_; c++){
+			prefixCostShortSucc_[c].assign(allowedShortSuccBySize_[c].size(), 0.0);
+			prefixStatusShortSucc_[c].assign(allowedShortSuccBySize_[c].size(), 0);
+		}
+	}
+
+	// 1. Find the days that changed
+	vector<bool> isDayChanged(nDays_, !isShortSuccWindowInit_);
+	for(int k=1; k<nDays_; k++){
+		for(int s=1; s<nShifts; s++){
+			int index = k*nShifts + s;
+			double cost = preferencesCosts_[k][s] - pCosts_->dayShiftWorkCost(k,s-1);
+			char status = dayShiftStatus_[k][s];
+			if(cost != lastDayShiftCost_[index] || status != lastDayShiftStatus_[index]){
+				lastDayShiftCost_[index] = cost;
+				lastDayShiftStatus_[index] = status;
+				isDayChanged[k] = true;
+			}
+		}
+	}
+	isShortSuccWindowInit_ = true;
+
+	// 2. Evaluate again the start dates with a changed day within the CDMin days of the successions
+	int nextChangedDay = nDays_;
+	for(int k=nDays_-1; k>=nStartDates; k--)
+		if(isDayChanged[k]) nextChangedDay = k;
+	for(int d=nStartDates-1; d>=1; d--){
+		if(isDayChanged[d]) nextChangedDay = d;
+		if(nextChangedDay > d+CDMin_-1) continue;
+
+		for(int c=1; c<=CDMin_; c++){
+			const int dayOffset = (d+c-1)*nShifts;
+			const vector<int>& lastShifts = lastShiftOfShortSucc_[c];
+			const vector<int>& parents = parentOfShortSucc_[c];
+			vector<double>& prefixCost = prefixCostShortSucc_[c];
+			vector<char>& prefixStatus = prefixStatusShortSucc_[c];
+			const int nSucc = prefixCost.size();
+			for(int i=0; i<nSucc; i++){
+				int index = dayOffset + lastShifts[i];
+				if(c == 1){
+					prefixCost[i] = lastDayShiftCost_[index];
+					prefixStatus[i] = lastDayShiftStatus_[index];
+				}
+				else {
+					prefixCost[i] = prefixCostShortSucc_[c-1][parents[i]] + lastDayShiftCost_[index];
+					prefixStatus[i] = prefixStatusShortSucc_[c-1][parents[i]] && lastDayShiftStatus_[index];
+				}
+			}
+		}
+		std::copy(prefixCostShortSucc_[CDMin_].begin(), prefixCostShortSucc_[CDMin_].end(),
+			windowCostShortSuccCDMin_.begin() + d*nSuccCDMin);
+		std::copy(prefixStatusShortSucc_[CDMin_].begin(), prefixStatusShortSucc_[CDMin_].end(),
+			windowStatusShortSuccCDMin_.begin() + d*nSuccCDMin);
+	}
+}
+
 // Given a short succession and a start date, returns the cost of the corresponding arc
 //
 double SubProblem::costArcShortSucc(int size, int succId, int startDate){
@@ -1083,6 +1326,39 @@ double SubProblem::costArcShortSucc(int size, int succId, int startDate){
 //
 //--------------------------------------------
 
+// Builds the tables of the arcs whose cost depend on the dual costs
+//
+void SubProblem::initArcCostTables(){
+	workArcs_.clear(); workArcsDay_.clear(); workArcsShift_.clear(); workArcsWeekend_.clear();
+	endArcs_.clear(); endArcsDay_.clear();
+
+	for(int s=1; s<pScenario_->nbShifts_; s++)
+		for(int k=CDMin_-1; k<nDays_-1; k++){
+			// SHIFT_TO_NEWSHIFT
+			vector<int> arcs;
+			for(int s0=1; s0<pScenario_->nbShifts_; s0++)
+				if(arcsShiftToNewShift_[s0][s][k] > 0) arcs.push_back(arcsShiftToNewShift_[s0][s][k]);
+			// SHIFT_TO_SAMESHIFT
+			for(int n=1; n<maxvalConsByShift_[s]; n++)
+				arcs.push_back(arcsShiftToSameShift_[s][k][n]);
+			// REPEATSHIFT
+			arcs.push_back(arcsRepeatShift_[s][k]);
+
+			for(int a: arcs){
+				workArcs_.push_back(a);
+				workArcsDay_.push_back(k+1);
+				workArcsShift_.push_back(s);
+				workArcsWeekend_.push_back(Tools::isSaturday(k+1) ? 1.0 : 0.0);
+			}
+		}
+
+	for(int s=1; s<pScenario_->nbShifts_; s++)
+		for(int k=CDMin_-1; k<nDays_; k++){
+			endArcs_.push_back(arcsPrincipalToRotsizein_[s][k]);
+			endArcsDay_.push_back(k);
+		}
+}
+
 // Updates the costs depending on the reduced costs given for the nurse
 //
 void SubProblem::updateArcCosts(){
@@ -1091,14 +1367,14 @@ void SubProblem::updateArcCosts(){
 
 	// A. ARCS : SOURCE_TO_PRINCIPAL [baseCost = 0]
 	//
-	shortSuccCDMinIdFromArc_.clear();
+	shortSuccCDMinIdFromArc_.assign(nArcs_, -1);
 	for(int s=1; s<pScenario_->nbShifts_; s++){
 		for(int k=CDMin_-1; k<nDays_; k++){
 			for(int n=1; n<=maxvalConsByShift_[s]; n++){
 				int a = arcsFromSource_[s][k][n];
 				double c = arcCostBestShortSuccCDMin_[s][k][n];
 				updateCost( a , c );
-				shortSuccCDMinIdFromArc_.insert(pair<int,int>( arcsFromSource_[s][k][n], idBestShortSuccCDMin_[s][k][n]));
+				shortSuccCDMinIdFromArc_[a] = idBestShortSuccCDMin_[s][k][n];
 			}
 		}
 
@@ -1113,57 +1389,26 @@ void SubProblem::updateArcCosts(){
 	}
 
 	// B. ARCS : SHIFT_TO_NEWSHIFT [baseCost = 0]
-	//
-	for(int s1=1; s1<pScenario_->nbShifts_; s1++)
-		for(int s2=1; s2<pScenario_->nbShifts_; s2++)
-			for(int k=CDMin_-1; k<nDays_-1; k++){
-				int a = arcsShiftToNewShift_[s1][s2][k];
-				if(a > 0){
-					double c = arcBaseCost_[a];
-					c += preferencesCosts_[k+1][s2] ;
-					c -= pCosts_->dayShiftWorkCost(k+1,s2-1);
-					c -= Tools::isSaturday(k+1) ? pCosts_->workedWeekendCost() : 0 ;
-					updateCost( a , c );
-				}
-			}
-
 	// C. ARCS : SHIFT_TO_SAMESHIFT [baseCost = 0]
+	// E. ARCS : REPEATSHIFT [baseCost contains consecutive shift cost]
 	//
-	for(int s=1; s<pScenario_->nbShifts_; s++)
-		for(int k=CDMin_-1; k<nDays_-1; k++)
-			for(int n=1; n<maxvalConsByShift_[s]; n++){
-				int a = arcsShiftToSameShift_[s][k][n];
-				double c = arcBaseCost_[a];
-				c += preferencesCosts_[k+1][s] ;
-				c -= pCosts_->dayShiftWorkCost(k+1,s-1);
-				if(Tools::isSaturday(k+1)) c-= pCosts_->workedWeekendCost();
-				updateCost( a , c );
-			}
+	// One pass on the table of the work arcs: base + preference - dual of the day - dual of the weekend
+	const double weekendCost = pCosts_->workedWeekendCost();
+	const int nWorkArcs = workArcs_.size();
+	for(int i=0; i<nWorkArcs; i++){
+		int a = workArcs_[i], k = workArcsDay_[i], s = workArcsShift_[i];
+		arcCost_[a] = arcBaseCost_[a] + preferencesCosts_[k][s] - pCosts_->dayShiftWorkCost(k,s-1) - workArcsWeekend_[i] * weekendCost;
+	}
 
 	// D. ARCS : SHIFT_TO_ENDSEQUENCE [They never change]
 
-	// E. ARCS : REPEATSHIFT [baseCost contains consecutive shift cost]
-	//
-	for(int s=1; s<pScenario_->nbShifts_; s++)
-		for(int k=CDMin_-1; k<nDays_-1; k++){
-			int a = arcsRepeatShift_[s][k];
-			double c = arcBaseCost_[a];
-			c += preferencesCosts_[k+1][s];
-			c -= pCosts_->dayShiftWorkCost(k+1,s-1);
-			if(Tools::isSaturday(k+1)) c-= pCosts_->workedWeekendCost();
-			updateCost( a , c );
-		}
-
 	// F. ARCS : PRINCIPAL_TO_ROTSIZE [baseCost contains complete weekend constraint]
 	//
-	for(int s=1; s<pScenario_->nbShifts_; s++)
-		for(int k=CDMin_-1; k<nDays_; k++){
-			int a = arcsPrincipalToRotsizein_[s][k];
-			double c = arcBaseCost_[a];
-			c += endWeekendCosts_[k];
-			c -= pCosts_->endWorkCost(k);
-			updateCost( a , c );
-		}
+	const int nEndArcs = endArcs_.size();
+	for(int i=0; i<nEndArcs; i++){
+		int a = endArcs_[i], k = endArcsDay_[i];
+		arcCost_[a] = arcBaseCost_[a] + endWeekendCosts_[k] - pCosts_->endWorkCost(k);
+	}
 
 	// G. ARCS : ROTSIZEIN_TO_ROTSIZE [baseCost contains rotation length cost. They never change]
 
@@ -1211,7 +1456,7 @@ void SubProblem::updatedMaxRotationLengthOnNodes(){
 
 // Returns true if the succession succ starting on day k does not violate any forbidden day-shift
 //
-bool SubProblem::canSuccStartHere(vector<int> succ, int firstDay){
+bool SubProblem::canSuccStartHere(const vector<int>& succ, int firstDay){
 	// If the starting date is forbidden, return false
 	if(!(startingDayStatus_[firstDay]))
 		return false;
@@ -1227,13 +1472,15 @@ bool SubProblem::canSuccStartHere(vector<int> succ, int firstDay){
 	return true;
 }
 
-// Forbids the nodes that correspond to forbidden shifts
+// Forbids the nodes that correspond to forbidden shifts and authorizes the others. The nodes stay forbidden
+// between two solves, so only the day-shifts whose status changed since the last solve are visited.
 //
-void SubProblem::forbid(set<pair<int,int> > forbiddenDayShifts){
-	for(pair<int,int> p : forbiddenDayShifts){
-		//std::cout << "# Trying to forbid " << p.first << "-" << pScenario_->intToShift_[p.second].at(0) << endl;
-		forbidDayShift(p.first,p.second);
-	}
+void SubProblem::updateForbiddenDayShifts(const Tools::BitMatrix& forbiddenDayShifts){
+	forbiddenDayShifts.visitDifferences(appliedForbiddenDayShifts_, [this](int k, int s, bool isForbidden){
+		if(isForbidden) forbidDayShift(k,s);
+		else authorizeDayShift(k,s);
+	});
+	appliedForbiddenDayShifts_ = forbiddenDayShifts;
 }
 
 // Forbid an arc
@@ -1254,15 +1501,6 @@ void SubProblem::forbidNode(int v){
 	}
 }
 
-// Authorize the nodes that correspond to forbidden shifts
-//
-void SubProblem::authorize(set<pair<int,int> > forbiddenDayShifts){
-	for(pair<int,int> p : forbiddenDayShifts){
-		//std::cout << "# Trying to forbid " << p.first << "-" << pScenario_->intToShift_[p.second].at(0) << endl;
-		authorizeDayShift(p.first,p.second);
-	}
-}
-
 // Authorize an arc
 //
 void SubProblem::authorizeArc(int a){
@@ -1278,7 +1516,7 @@ void SubProblem::authorizeNode(int v){
 	if(isNodeForbidden(v)){
 		nodeStatus_[v] = true;
 		int lat = maxRotationLength_;
-		if(nodeType(v) == ROTATION_LENGTH) lat = rotationLengthNodesLAT_.at(v);
+		if(nodeType(v) == ROTATION_LENGTH) lat = rotationLengthNodesLAT_[v];
 		updateLat(v,lat);
 	}
 }
@@ -1326,18 +1564,14 @@ void SubProblem::authorizeDayShift(int k, int s){
 	}
 }
 
-// Forbids some starting days
+// Forbids some starting days and authorizes the others (only those whose status changed since the last solve)
 //
-void SubProblem::forbidStartingDays(set<int> forbiddenStartingDays){
-	for(int k: forbiddenStartingDays)
-		forbidStartingDay(k);
-}
-
-// Authorizes some starting days
-//
-void SubProblem::authorizeStartingDays(set<int> authorizedStartingDays){
-	for(int k: authorizedStartingDays)
-		authorizeStartingDay(k);
+void SubProblem::updateForbiddenStartingDays(const Tools::BitMatrix& forbiddenStartingDays){
+	forbiddenStartingDays.visitDifferences(appliedForbiddenStartingDays_, [this](int k, int, bool isForbidden){
+		if(isForbidden) forbidStartingDay(k);
+		else authorizeStartingDay(k);
+	});
+	appliedForbiddenStartingDays_ = forbiddenStartingDays;
 }
 
 // Forbids a starting date: no rotation can now start on that day. Gives a prohibitive resource consumption on all short
@@ -1357,13 +1591,10 @@ void SubProblem::authorizeStartingDay(int k){
 	startingDayStatus_[k] = true;
 }
 
-// Reset all authorizations to true
+// Reset the authorizations of the arcs to true. The day-shifts and starting days are not reset: they are updated
+// with the forbidden lists of the next solve
 //
 void SubProblem::resetAuthorizations(){
-	for(int s=1; s<pScenario_->nbShifts_; s++)
-		for(int k=0; k<nDays_; k++)
-			authorizeDayShift(k,s);
-
 	for(int a=0; a<nArcs_; a++)
 		authorizeArc(a);
 }
@@ -2059,6 +2290,418 @@ void SubProblem::r_c_shortest_paths_dispatch_several_sinks( const Graph& g,
 
 
 
+//----------------------------------------------------------------
+//
+// Layered label-setting algorithm
+// The network is acyclic: the nodes are processed in a topological
+// order, so all the labels of a node are known (and final) when the
+// node is extended. It returns the same Pareto-optimal paths as
+// r_c_shortest_paths_several_sinks (same extension and dominance).
+//
+//----------------------------------------------------------------
+
+// Computes the topological order of the nodes (Kahn's algorithm)
+//
+void SubProblem::initTopologicalOrder(){
+	vector<int> nbInArcs (nNodes_, 0);
+	for(int a=0; a<nArcs_; a++)
+		nbInArcs[arcDestination(a)] ++;
+
+	topologicalOrder_.clear();
+	for(int v=0; v<nNodes_; v++)
+		if(nbInArcs[v] == 0) topologicalOrder_.push_back(v);
+
+	for(unsigned int i=0; i<topologicalOrder_.size(); i++){
+		int v = topologicalOrder_[i];
+		for(int j=outArcsStart_[v]; j<outArcsStart_[v+1]; j++){
+			int w = arcDestination_[outArcs_[j]];
+			if(--nbInArcs[w] == 0) topologicalOrder_.push_back(w);
+		}
+	}
+
+	if((int) topologicalOrder_.size() != nNodes_)
+		Tools::throwError("SubProblem::initTopologicalOrder: the rotation network is not acyclic!");
+
+	labelsByNode_.clear();
+	labelsByNode_.resize(nNodes_);
+	backwardLabelsByNode_.clear();
+	backwardLabelsByNode_.resize(nNodes_);
+}
+
+// Computes the day of each node: the day of the shift for the principal network, the day of the rotation length check
+// for its subnetwork. Every arc goes from a day to the same or a later one, so a path crosses a given day only once.
+//
+void SubProblem::initNodeDays(){
+	nodeDay_.assign(nNodes_, -1);
+	for(int v=0; v<nNodes_; v++)
+		if(nodeType(v) == PRINCIPAL_NETWORK) nodeDay_[v] = principalToDay_[v];
+	for(int k=0; k<nDays_; k++){
+		nodeDay_[rotationLengthEntrance_[k]] = k;
+		for(int v: rotationLengthNodes_[k]) nodeDay_[v] = k;
+		nodeDay_[sinkNodesByDay_[k]] = k;
+	}
+	nodeDay_[sourceNode_] = -1;
+	nodeDay_[sinkNode_] = nDays_;
+
+	for(int a=0; a<nArcs_; a++)
+		if(nodeDay_[arcOrigin_[a]] > nodeDay_[arcDestination_[a]])
+			Tools::throwError("SubProblem::initNodeDays: an arc of the rotation network goes back in time!");
+}
+
+// Computes, for each node, the cost of the cheapest path to one of the sinks (the resource windows are ignored, except
+// for the forbidden arcs). A label whose cost plus this bound is not below maxReducedCostBound_ cannot give a rotation.
+//
+void SubProblem::computeCompletionBounds(const vector<bool>& isSink){
+	completionBound_.assign(nNodes_, DBL_MAX);
+	for(vector<int>::reverse_iterator it = topologicalOrder_.rbegin(); it != topologicalOrder_.rend(); ++it){
+		int v = *it;
+		if(isSink[v]){
+			completionBound_[v] = 0;
+			continue;
+		}
+		for(int j=outArcsStart_[v]; j<outArcsStart_[v+1]; j++){
+			int a = outArcs_[j];
+			int w = arcDestination_[a];
+			if(completionBound_[w] == DBL_MAX or arcTime_[a] > nodeLat_[w]) continue;
+			completionBound_[v] = min(completionBound_[v], arcCost_[a] + completionBound_[w]);
+		}
+	}
+}
+
+// Computes, for each node, the cost of the cheapest path from the source (same rules as the completion bounds). A
+// backward label whose cost plus this bound is not below maxReducedCostBound_ cannot give a rotation.
+//
+void SubProblem::computeOriginBounds(){
+	originBound_.assign(nNodes_, DBL_MAX);
+	originBound_[sourceNode_] = 0;
+	for(int v: topologicalOrder_){
+		if(originBound_[v] == DBL_MAX) continue;
+		for(int j=outArcsStart_[v]; j<outArcsStart_[v+1]; j++){
+			int a = outArcs_[j];
+			int w = arcDestination_[a];
+			if(arcTime_[a] > nodeLat_[w]) continue;
+			originBound_[w] = min(originBound_[w], originBound_[v] + arcCost_[a]);
+		}
+	}
+}
+
+// Adds the label to node v if no label of v dominates it, and removes the labels of v that it dominates
+// (in case of equality, the oldest label is kept as in boost)
+//
+void SubProblem::addLayeredLabel(int v, const spp_spptw_res_cont& res, int pred, int arc){
+	dominance_spptw dominance;
+	vector<int>& labels = labelsByNode_[v];
+	for(int l: labels)
+		if(dominance(labelPool_[l].res, res)){
+			nLabelsDominated_++;
+			return;
+		}
+
+	unsigned int nKept = 0;
+	for(unsigned int i=0; i<labels.size(); i++)
+		if(!dominance(res, labelPool_[labels[i]].res)) labels[nKept++] = labels[i];
+	nLabelsDominated_ += labels.size() - nKept;
+	labels.resize(nKept);
+	nLabelsCreated_++;
+
+	labels.push_back(labelPool_.size());
+	labelPool_.push_back(layered_label(res, pred, arc));
+}
+
+// Same as addLayeredLabel for the backward labels: a label dominates another one if it ends at the same sink, if it is
+// not more expensive, not longer, and if it accepts the same forward paths (slack not smaller)
+//
+void SubProblem::addBackwardLabel(int v, const backward_label& label){
+	vector<int>& labels = backwardLabelsByNode_[v];
+	for(int l: labels){
+		const backward_label& other = backwardLabelPool_[l];
+		if(other.sink == label.sink and other.cost <= label.cost and other.time <= label.time and other.slack >= label.slack){
+			nLabelsDominated_++;
+			return;
+		}
+	}
+
+	unsigned int nKept = 0;
+	for(unsigned int i=0; i<labels.size(); i++){
+		const backward_label& other = backwardLabelPool_[labels[i]];
+		if(!(other.sink == label.sink and label.cost <= other.cost and label.time <= other.time and label.slack >= other.slack))
+			labels[nKept++] = labels[i];
+	}
+	nLabelsDominated_ += labels.size() - nKept;
+	labels.resize(nKept);
+	nLabelsCreated_++;
+
+	labels.push_back(backwardLabelPool_.size());
+	backwardLabelPool_.push_back(label);
+}
+
+// Initializes the label of the source and extends the labels of each node of the days up to lastDay, in the
+// topological order (same extension as ref_spptw, but on the compact graph)
+//
+void SubProblem::extendForwardLabels(const vector<bool>& isSink, int lastDay){
+	labelPool_.clear();
+	for(vector<int>& labels: labelsByNode_) labels.clear();
+	labelPool_.push_back(layered_label(spp_spptw_res_cont(0,0)));
+	labelsByNode_[sourceNode_].push_back(0);
+
+	for(int v: topologicalOrder_){
+		if(isSink[v] or nodeDay_[v] > lastDay) continue;
+		for(int l: labelsByNode_[v]){
+			for(int j=outArcsStart_[v]; j<outArcsStart_[v+1]; j++){
+				int a = outArcs_[j];
+				int w = arcDestination_[a];
+				if(nodeDay_[w] > lastDay) continue;
+				spp_spptw_res_cont res (labelPool_[l].res.cost + arcCost_[a], max(labelPool_[l].res.time + arcTime_[a], nodeEat_[w]));
+				if(res.time > nodeLat_[w]) continue;
+				// no rotation with a small enough reduced cost can be obtained from this label
+				if(res.cost + completionBound_[w] >= maxReducedCostBound_ + EPSILON) continue;
+				addLayeredLabel(w, res, l, a);
+			}
+		}
+	}
+}
+
+// Builds the rotation of a path of the network (arcs from the last to the first as in boost)
+//
+void SubProblem::addRotationFromLabelArcs(const vector<int>& arcs, double cost){
+	Rotation rot = rotationFromArcs(arcs, cost);
+	theRotations_.push_back(rot);
+	nPaths_ ++;
+	nLongFound_++;
+	bestReducedCost_ = min(bestReducedCost_, rot.dualCost_);
+}
+
+// Solves the shortest path problem with the layered label-setting algorithm
+//
+bool SubProblem::solveLongRotationsLayered(){
+
+	// THE SINKS (same as in solveLongRotationsOptimal)
+	//
+	vector<int> sinks;
+	if(param_.oneSinkNodePerLastDay_){
+		for(int k=CDMin_-1; k<nDays_; k++)
+			sinks.push_back( sinkNodesByDay_[k] );
+	}
+	else
+		sinks.push_back( sinkNode_ );
+	vector<bool> isSink (nNodes_, false);
+	for(int v: sinks) isSink[v] = true;
+
+	// INITIALIZATION: bounds (the memory of the buckets is kept from one solve to the next)
+	//
+	computeCompletionBounds(isSink);
+
+	// EXTEND THE LABELS OF EACH NODE, IN THE TOPOLOGICAL ORDER
+	//
+	extendForwardLabels(isSink, nDays_);
+
+	// BUILD THE ROTATIONS ARRIVING AT THE SINKS
+	//
+	int nFound = 0;
+	for(int v: sinks){
+		for(int l: labelsByNode_[v]){
+			if(labelPool_[l].res.cost >= maxReducedCostBound_) continue;
+			vector<int> arcs;
+			for(int i=l; labelPool_[i].pred >= 0; i=labelPool_[i].pred)
+				arcs.push_back(labelPool_[i].arc);
+			addRotationFromLabelArcs(arcs, labelPool_[l].res.cost);
+			nFound ++;
+		}
+	}
+	return (nFound > 0);
+}
+
+// Solves the shortest path problem with the bidirectional label-setting algorithm. The forward labels are extended
+// from the source to the nodes of the days up to the half-way day, and the backward labels from the sinks to the nodes
+// of the later days. Each path crosses the half-way day on a single arc, where its two halves are joined. The nodes
+// have no earliest arrival time (all nodeEat_ are 0), so the time of a joined path is the sum of the times of its
+// halves, and the backward labels only need to know the largest time with which they can be reached (slack).
+// The rotations are the same as with the forward algorithm: for each sink, the paths that are not dominated in cost
+// and time (up to the ties).
+//
+bool SubProblem::solveLongRotationsBidirectional(){
+
+	// THE SINKS (same as in solveLongRotationsOptimal)
+	//
+	vector<int> sinks;
+	if(param_.oneSinkNodePerLastDay_){
+		for(int k=CDMin_-1; k<nDays_; k++)
+			sinks.push_back( sinkNodesByDay_[k] );
+	}
+	else
+		sinks.push_back( sinkNode_ );
+	vector<bool> isSink (nNodes_, false);
+	for(int v: sinks) isSink[v] = true;
+
+	// the forward labels go up to the half-way day, the backward labels start after it
+	const int halfWayDay = (nDays_-1)/2;
+
+	// FORWARD LABELS, PRUNED WITH THE COMPLETION BOUNDS
+	//
+	computeCompletionBounds(isSink);
+	extendForwardLabels(isSink, halfWayDay);
+
+	// BACKWARD LABELS, PRUNED WITH THE ORIGIN BOUNDS
+	//
+	// In the reverse topological order, all the labels of the successors of a node are final when it is processed
+	computeOriginBounds();
+	backwardLabelPool_.clear();
+	for(vector<int>& labels: backwardLabelsByNode_) labels.clear();
+	for(vector<int>::reverse_iterator it = topologicalOrder_.rbegin(); it != topologicalOrder_.rend(); ++it){
+		int v = *it;
+		if(nodeDay_[v] <= halfWayDay) continue;
+		if(isSink[v]){
+			addBackwardLabel(v, backward_label(0, 0, nodeLat_[v], v));
+			continue;
+		}
+		for(int j=outArcsStart_[v]; j<outArcsStart_[v+1]; j++){
+			int a = outArcs_[j];
+			int w = arcDestination_[a];
+			for(int l: backwardLabelsByNode_[w]){
+				const backward_label& next = backwardLabelPool_[l];
+				backward_label label (next.cost + arcCost_[a], next.time + arcTime_[a],
+						min(nodeLat_[v], next.slack - arcTime_[a]), next.sink, l, a);
+				if(label.slack < 0) continue;
+				// no rotation with a small enough reduced cost can be obtained from this label
+				if(label.cost + originBound_[v] >= maxReducedCostBound_ + EPSILON) continue;
+				addBackwardLabel(v, label);
+			}
+		}
+	}
+
+	// the backward labels of each node are sorted by cost, so that the join stops at the first one that is too expensive
+	for(vector<int>& labels: backwardLabelsByNode_)
+		std::sort(labels.begin(), labels.end(), [this](int l1, int l2){
+			return backwardLabelPool_[l1].cost < backwardLabelPool_[l2].cost;
+		});
+
+	// JOIN THE LABELS ON THE ARCS THAT CROSS THE HALF-WAY DAY
+	//
+	// paths found for each sink: (cost, time) and (forward label, arc, backward label)
+	struct JoinedPath{
+		double cost;
+		int time;
+		int forwardLabel;
+		int arc;
+		int backwardLabel;
+	};
+	vector< vector<JoinedPath> > pathsBySink (nNodes_);
+	for(int v: topologicalOrder_){
+		if(nodeDay_[v] > halfWayDay or isSink[v]) continue;
+		for(int j=outArcsStart_[v]; j<outArcsStart_[v+1]; j++){
+			int a = outArcs_[j];
+			int w = arcDestination_[a];
+			if(nodeDay_[w] <= halfWayDay) continue;
+			for(int l: labelsByNode_[v]){
+				const spp_spptw_res_cont& res = labelPool_[l].res;
+				int time = res.time + arcTime_[a];
+				for(int b: backwardLabelsByNode_[w]){
+					const backward_label& label = backwardLabelPool_[b];
+					double cost = res.cost + arcCost_[a] + label.cost;
+					if(cost >= maxReducedCostBound_) break;
+					if(time > label.slack) continue;
+					JoinedPath path = {cost, time + label.time, l, a, b};
+					pathsBySink[label.sink].push_back(path);
+				}
+			}
+		}
+	}
+
+	// BUILD THE ROTATIONS
+	//
+	int nFound = 0;
+	for(int v: sinks){
+		// the paths that end in the first half are those of the forward labels
+		if(nodeDay_[v] <= halfWayDay){
+			for(int l: labelsByNode_[v]){
+				if(labelPool_[l].res.cost >= maxReducedCostBound_) continue;
+				vector<int> arcs;
+				for(int i=l; labelPool_[i].pred >= 0; i=labelPool_[i].pred)
+					arcs.push_back(labelPool_[i].arc);
+				addRotationFromLabelArcs(arcs, labelPool_[l].res.cost);
+				nFound ++;
+			}
+			continue;
+		}
+
+		// keep the joined paths that are not dominated (by increasing cost, a path is kept if it is shorter than the
+		// previous ones)
+		vector<JoinedPath>& paths = pathsBySink[v];
+		std::stable_sort(paths.begin(), paths.end(), [](const JoinedPath& p1, const JoinedPath& p2){
+			return p1.cost < p2.cost or (p1.cost == p2.cost and p1.time < p2.time);
+		});
+		int minTime = MAX_TIME;
+		for(const JoinedPath& path: paths){
+			if(path.time >= minTime) continue;
+			minTime = path.time;
+			vector<int> arcs;
+			for(int i=path.backwardLabel; backwardLabelPool_[i].succ >= 0; i=backwardLabelPool_[i].succ)
+				arcs.push_back(backwardLabelPool_[i].arc);
+			std::reverse(arcs.begin(), arcs.end());
+			arcs.push_back(path.arc);
+			for(int i=path.forwardLabel; labelPool_[i].pred >= 0; i=labelPool_[i].pred)
+				arcs.push_back(labelPool_[i].arc);
+			addRotationFromLabelArcs(arcs, path.cost);
+			nFound ++;
+		}
+	}
+	return (nFound > 0);
+}
+
+// Checks that the forward and the bidirectional labelings find the same rotations with the current costs. In case of a
+// tie, the two algorithms may keep different paths: the rotations are thus compared by last day, length and cost.
+// The solutions found before the call are restored afterwards.
+//
+void SubProblem::compareLabelings(){
+
+	vector<Rotation> rotations = theRotations_;
+	int nPaths = nPaths_, nLongFound = nLongFound_;
+	double bestReducedCost = bestReducedCost_;
+
+	// the rotations found by an algorithm, sorted by (last day, length, cost)
+	auto solveAndSort = [this](bool bidirectional){
+		theRotations_.clear();
+		if(bidirectional) solveLongRotationsBidirectional();
+		else solveLongRotationsLayered();
+		vector<Rotation> found = theRotations_;
+		std::sort(found.begin(), found.end(), [](const Rotation& r1, const Rotation& r2){
+			int last1 = r1.firstDay_+r1.length_, last2 = r2.firstDay_+r2.length_;
+			if(last1 != last2) return last1 < last2;
+			if(r1.length_ != r2.length_) return r1.length_ < r2.length_;
+			return r1.dualCost_ < r2.dualCost_;
+		});
+		return found;
+	};
+	vector<Rotation> forwardRotations = solveAndSort(false);
+	vector<Rotation> bidirectionalRotations = solveAndSort(true);
+
+	if(forwardRotations.size() != bidirectionalRotations.size()){
+		std::cout << "# " << forwardRotations.size() << " rotations with the forward labeling, "
+				<< bidirectionalRotations.size() << " with the bidirectional one" << std::endl;
+		Tools::throwError("SubProblem::compareLabelings: the labeling algorithms do not find the same number of rotations!");
+	}
+	for(unsigned int i=0; i<forwardRotations.size(); i++){
+		Rotation& r1 = forwardRotations[i];
+		Rotation& r2 = bidirectionalRotations[i];
+		if(r1.firstDay_+r1.length_ != r2.firstDay_+r2.length_ or r1.length_ != r2.length_
+				or fabs(r1.dualCost_-r2.dualCost_) > EPSILON){
+			std::cout << "# Forward rotation: " << r1.toString(nDays_);
+			std::cout << "# Bidirectional rotation: " << r2.toString(nDays_);
+			Tools::throwError("SubProblem::compareLabelings: the labeling algorithms do not find the same rotations!");
+		}
+	}
+
+	theRotations_ = rotations;
+	nPaths_ = nPaths;
+	nLongFound_ = nLongFound;
+	bestReducedCost_ = bestReducedCost;
+}
+
+
+
+
+
+
 //----------------------------------------------------------------
 //
 // Greedy heuristic for the shortest path problem with resource
@@ -2092,7 +2735,7 @@ bool SubProblem::solveLongRotationsHeuristic(){
 				vector<int> bestSuccCDMinDays;
 				for(int newSh=1; newSh<pScenario_->nbShifts_; newSh++){
 					for(int i=0; i<allowedShortSuccBySize_[CDMin_].size(); i++){
-						vector<int> succ = allowedShortSuccBySize_[CDMin_][i];
+						const vector<int>& succ = allowedShortSuccBySize_[CDMin_][i];
 						double potentialCost = costOfVeryShortRotation(startDate,succ);
 						// Store the rotation if it is good
 						if(potentialCost < maxReducedCostBound_){
@@ -2502,8 +3145,8 @@ void SubProblem::printRotation(Rotation rot){
 	std::cout << "# \t| ROTATION:" << "  cost=" << rot.cost_ << "  dualCost=" << rot.dualCost_ << "  firstDay=" << rot.firstDay_ << "  length=" << rot.length_ << std::endl;
 	std::cout << "# \t            |";
 	vector<int> allTasks (nDays_);
-	for(map<int,int>::iterator itTask = rot.shifts_.begin(); itTask != rot.shifts_.end(); ++itTask)
-		allTasks[itTask->first] = itTask->second;
+	for(pair<int,int> task: rot.shifts_)
+		allTasks[task.first] = task.second;
 	for(int i=0; i<allTasks.size(); i++){
 		if(allTasks[i] < 1) std::cout << " |";
 		else std::cout << pScenario_->intToShift_[allTasks[i]].at(0) << "|";
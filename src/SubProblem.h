@@ -17,6 +17,10 @@
 #include "boost/config.hpp"
 #include <boost/graph/r_c_shortest_paths.hpp>
 
+#include <mutex>
+#include <memory>
+#include <deque>
+
 
 static int MAX_COST = 99999;
 static int MAX_TIME = 99999;
@@ -44,9 +48,6 @@ static const vector<string> arcTypeName = {
 		"REPEATSHIFT    ", "PPL_TO_ROTSIZE ", "ROTSZIN_TO_RTSZ", "ROTSIZE_TO_SINK",
 		"SINKDAY TO SINK", "NONE           "};
 
-static const set<pair<int,int> > EMPTY_FORBIDDEN_LIST;
-static const set<int> EMPTY_FORBIDDEN_STARTING_DATES_LIST;
-
 // Parameters (called in the solve function)
 //
 struct SubproblemParam{
@@ -112,17 +113,29 @@ struct SubproblemParam{
 	// false -> one single sink node for the network
 	bool oneSinkNodePerLastDay_ = false;
 
+	// true  -> the long rotations are priced with the layered label-setting algorithm
+	// false -> the long rotations are priced with boost r_c_shortest_paths
+	bool layeredLabeling_ = false;
+
+	// true  -> the long rotations are priced with the bidirectional label-setting algorithm
+	//          (labels from the source and from the sinks, joined on the half-way day)
+	bool bidirectionalLabeling_ = false;
+
 	// Getters for the class fields
 	//
 	int maxRotationLength(){ return maxRotationLength_; }
 	int shortRotationsStrategy(){return shortRotationsStrategy_;}
 	bool oneSinkNodePerLastDay(){return oneSinkNodePerLastDay_;}
+	bool layeredLabeling(){return layeredLabeling_;}
+	bool bidirectionalLabeling(){return bidirectionalLabeling_;}
 
 	// Setters
 	//
 	void maxRotationLength(int value){maxRotationLength_ = value;}
 	void shortRotationsStrategy(int value){shortRotationsStrategy_ = value;}
 	void oneSinkNodePerLastDay(bool value){oneSinkNodePerLastDay_ = value;}
+	void layeredLabeling(bool value){layeredLabeling_ = value;}
+	void bidirectionalLabeling(bool value){bidirectionalLabeling_ = value;}
 
 
 };
@@ -334,6 +347,66 @@ public:
 	}
 };
 
+// Visitor of the boost algorithm that counts the feasible labels and the dominated ones
+struct counting_visitor_spptw: public boost::default_r_c_shortest_paths_visitor{
+	counting_visitor_spptw(int* nCreated, int* nDominated): nCreated_(nCreated), nDominated_(nDominated) {}
+	template<class Label, class Graph> void on_label_feasible( const Label&, const Graph& ) { ++ *nCreated_; }
+	template<class Label, class Graph> void on_label_dominated( const Label&, const Graph& ) { ++ *nDominated_; }
+	int* nCreated_;
+	int* nDominated_;
+};
+
+// Label of the layered label-setting algorithm: the resources of the path and
+// the label / arc it comes from (-1 for the label of the source)
+struct layered_label{
+
+	// Constructor
+	//
+	layered_label( spp_spptw_res_cont r = spp_spptw_res_cont(), int p = -1, int a = -1 ) : res( r ), pred( p ), arc( a ) {}
+
+	// Resources (cost + time) of the path
+	//
+	spp_spptw_res_cont res;
+
+	// Index of the predecessor label in the label pool
+	//
+	int pred;
+
+	// Id of the last arc of the path
+	//
+	int arc;
+};
+
+// Label of the backward labeling of the bidirectional algorithm: a path from a
+// node to a sink. Its resources are the cost and the time of the path, and the
+// largest time with which a forward path can reach its first node (slack), given
+// the latest arrival times of the nodes of the path
+struct backward_label{
+
+	// Constructor
+	//
+	backward_label( double c = 0, int t = 0, int sl = 0, int k = -1, int s = -1, int a = -1 ) :
+		cost( c ), time( t ), slack( sl ), sink( k ), succ( s ), arc( a ) {}
+
+	// Resources of the path
+	//
+	double cost;
+	int time;
+	int slack;
+
+	// Sink at the end of the path
+	//
+	int sink;
+
+	// Index of the successor label in the backward label pool
+	//
+	int succ;
+
+	// Id of the first arc of the path
+	//
+	int arc;
+};
+
 /////////////////////////////////////////////////////////////////////////////
 
 
@@ -402,6 +475,21 @@ public:
 	//
 	SubProblem(Scenario* scenario, int nbDays, const Contract* contract, vector<State>* pInitState);
 
+	// Constructor that copies the graph of a skeleton built for the same contract, number of days and initial states.
+	// Only the scenario and the contract are replaced.
+	//
+	SubProblem(Scenario* scenario, const Contract* contract, const SubProblem& skeleton);
+
+	// Returns a new subproblem, copied from the skeleton of the process-wide cache when the same contract, number of
+	// days and maximum number of ongoing worked days have already been met (the skeleton is built otherwise).
+	// The cache is thread-safe, and it keeps at most MAX_NB_SKELETONS skeletons (the oldest ones are removed first).
+	//
+	static SubProblem* buildFromCache(Scenario* scenario, int nbDays, const Contract* contract, vector<State>* pInitState);
+
+	// Removes all the skeletons of the cache (the subproblems that were copied from them are not affected)
+	//
+	static void clearSkeletonCache();
+
 	// Initialization function for all global variables (not those of the graph)
 	//
 	void init(vector<State>* pInitState);
@@ -411,11 +499,11 @@ public:
 	void testGraph_spprc();
 
 	// Solve : Returns TRUE if negative reduced costs path were found; FALSE otherwise.
+	// The forbidden day-shifts are a (day x shift) bit matrix, and the forbidden starting days a (day x 1) one.
 	//
 	bool solve(LiveNurse* nurse, DualCosts * costs, SubproblemParam param,
-			set<pair<int,int> > forbiddenDayShifts = EMPTY_FORBIDDEN_LIST,
-			set<int> forbiddenStartingDays = EMPTY_FORBIDDEN_STARTING_DATES_LIST, bool optimality = false,
-			double redCostBound = 0);
+			const Tools::BitMatrix& forbiddenDayShifts, const Tools::BitMatrix& forbiddenStartingDays,
+			bool optimality = false, double redCostBound = 0);
 
 	// Returns all rotations saved during the process of solving the SPPRC
 	//
@@ -495,6 +583,11 @@ protected:
 	//
 	double bestReducedCost_;
 
+	// Number of labels created and dominated when solving the long rotations
+	//
+	int nLabelsCreated_;
+	int nLabelsDominated_;
+
 
 
 	//----------------------------------------------------------------
@@ -529,6 +622,13 @@ protected:
 	// WARNING : for those that never change, of no use also.
 	vector<double> arcBaseCost_;
 
+	// Table of the arcs whose cost is updated with the duals of a worked day (SHIFT_TO_NEWSHIFT, SHIFT_TO_SAMESHIFT and
+	// REPEATSHIFT arcs): for each of them, its id, the day and shift it represents and 1 if the day is a saturday (0 otherwise)
+	vector<int> workArcs_, workArcsDay_, workArcsShift_;
+	vector<double> workArcsWeekend_;
+	// Table of the PRINCIPAL_TO_ROTSIZE arcs: for each of them, its id and the day of the end of the rotation
+	vector<int> endArcs_, endArcsDay_;
+
     // For each day k (<= nDays_ - CDMin), contains WEIGHT_COMPLETE_WEEKEND if [it is a Saturday (resp. Sunday) AND the contract requires complete weekends]; 0 otherwise.
 	vector<double> startWeekendCosts_, endWeekendCosts_;
 	// Costs due to preferences of the nurse: for each day k (<= nDays_ - CDMin), shift s, contains WEIGHT_PREFERENCES if (k,s) is a preference of the nurse; 0 otherwise.
@@ -555,6 +655,7 @@ protected:
 	vector3D allowedShortSuccBySize_;														// For each size c \in [0,CDMin], contains all allowed short successions of that size (satisfies succession constraints)
 	vector2D lastShiftOfShortSucc_;															// For each size c \in [0,CDMin], for each short rotation of size c, contains the corresponding last shift performed
 	vector2D nLastShiftOfShortSucc_;														// For each size c \in [0,CDMin], for each short rotation of size c, contains the number of consecutive days the last shift has been performed
+	vector2D parentOfShortSucc_;															// For each size c \in [0,CDMin], for each short rotation of size c, contains the id of the short rotation of size c-1 made of its c-1 first shifts (-1 if c=1)
 	// Objects for short successions of maximal size CDMin
 	int CDMin_;																				// Minimum number of consecutive days worked for free
 	vector3D allShortSuccCDMinByLastShiftCons_;												// For each shift s, for each number of days n, contains the list of short successions of size CDMin ending with n consecutive days of shift s
@@ -581,13 +682,13 @@ protected:
 	// Nodes of the PRINCIPAL_NETWORK subnetwork
 	vector3D principalNetworkNodes_;					// For each SHIFT, DAY, and # of CONSECUTIVE, the corresponding node id
 	vector<int> maxvalConsByShift_;						// For each shift, number of levels that the subnetwork contains
-	map<int,int> principalToShift_;						// For each node of the principal network, maps it ID to the shift it represents
-	map<int,int> principalToDay_;						// For each node of the principal network, maps it ID to the day it represents
-	map<int,int> principalToCons_;						// For each node of the principal network, maps it ID to the number of consecutive shifts it represents
+	vector<int> principalToShift_;						// For each node, the shift it represents (-1 if not in the principal network)
+	vector<int> principalToDay_;						// For each node, the day it represents (-1 if not in the principal network)
+	vector<int> principalToCons_;						// For each node, the number of consecutive shifts it represents (-1 if not in the principal network)
 	// Nodes of the ROTATION_LENGTH subnetwork
 	vector<int> rotationLengthEntrance_;				// For each day, entrance node to the ROTATION_LENGTH subnetwork
-	vector<map<int,int> > rotationLengthNodes_;			// For each day, maps the length of the rotation to the corresponding check node
-	map<int,int> rotationLengthNodesLAT_;				// For each rotation length node, the corresponding EAT
+	vector2D rotationLengthNodes_;						// For each day, the check node of each rotation length l (index l-CD_max)
+	vector<int> rotationLengthNodesLAT_;				// For each node, the LAT if it is a rotation length node (-1 otherwise)
 	vector<int> sinkNodesByDay_;						// For each day, an intermediary sink node (to get the Pareto-front for each day)
 	// Sink Node
 	int sinkNode_;
@@ -604,9 +705,9 @@ protected:
 	// Add a node to the principal network of the graph, for shift sh, day k, and number of consecutive similar shifts cons
 	void addNodeToPrincipalNetwork(int sh, int k, int cons);
 	// Get info from the node ID
-	inline NodeType nodeType(int v){return get( &Vertex_Properties::type, g_)[v];}
-	inline int nodeEat(int v){return get( &Vertex_Properties::eat, g_)[v];}
-	inline int nodeLat(int v){return get( &Vertex_Properties::lat, g_)[v];}
+	inline NodeType nodeType(int v){return allNodesTypes_[v];}
+	inline int nodeEat(int v){return nodeEat_[v];}
+	inline int nodeLat(int v){return nodeLat_[v];}
 
 
 
@@ -651,10 +752,38 @@ protected:
 
 	// Get info with the arc ID
 	inline ArcType arcType(int a) {return allArcsTypes_[a];}
-	inline int arcOrigin(int a) {return source(arcsDescriptors_[a], g_);}
-	inline int arcDestination(int a) {return target(arcsDescriptors_[a], g_);}
-	inline int arcLength(int a) {return get( &Arc_Properties::time, g_, arcsDescriptors_[a]);}
-	inline double arcCost(int a) {return get( &Arc_Properties::cost, g_, arcsDescriptors_[a]);}
+	inline int arcOrigin(int a) {return arcOrigin_[a];}
+	inline int arcDestination(int a) {return arcDestination_[a];}
+	inline int arcLength(int a) {return arcTime_[a];}
+	inline double arcCost(int a) {return arcCost_[a];}
+
+
+
+
+	//-----------------------
+	// THE COMPACT GRAPH
+	//-----------------------
+
+	// COMPACT GRAPH -> OBJECTS
+	//
+	// The solve functions work on a compressed sparse row copy of the graph: the resources of the nodes and arcs are
+	// stored in flat arrays indexed by their id. The boost graph g_ is only updated (in one sweep) before calling the
+	// boost algorithms.
+	vector<int> nodeEat_;								// For each node, its earliest arrival time
+	vector<int> nodeLat_;								// For each node, its latest arrival time
+	vector<int> arcOrigin_;								// For each arc, its origin
+	vector<int> arcDestination_;						// For each arc, its destination
+	vector<double> arcCost_;							// For each arc, its current cost
+	vector<int> arcTime_;								// For each arc, its current travel time
+	vector<int> outArcsStart_;							// For each node v, its out arcs are outArcs_[outArcsStart_[v]...outArcsStart_[v+1]-1]
+	vector<int> outArcs_;								// Ids of the arcs sorted by origin (in the order of creation)
+
+	// COMPACT GRAPH -> FUNCTIONS
+	//
+	// Builds the out arcs of each node. Should only be called ONCE (when creating the SubProblem).
+	void initCompactGraph();
+	// Copies the costs, travel times and latest arrival times into the boost graph
+	void updateBoostGraph();
 
 
 
@@ -692,6 +821,12 @@ protected:
 	// Function called when optimal=true in the arguments of solve
 	bool solveLongRotationsOptimal();
 	bool solveLongRotationsHeuristic();
+	// Label-setting algorithm that uses the structure of the network (acyclic, ordered by days)
+	bool solveLongRotationsLayered();
+	// Same algorithm from the source and from the sinks, the two label sets being joined on the half-way day
+	bool solveLongRotationsBidirectional();
+	// Checks that the two algorithms above return the same rotations (enabled with COMPARE_LABELINGS)
+	void compareLabelings();
 
 	// Initializes some cost vectors that depend on the nurse
 	void initStructuresForSolve();
@@ -701,13 +836,15 @@ protected:
 	bool addRotationsFromPaths(vector< vector< boost::graph_traits<Graph>::edge_descriptor > > paths, vector<spp_spptw_res_cont> resources);
 	// Returns the rotation made from the given path
 	Rotation rotationFromPath(vector< boost::graph_traits<Graph>::edge_descriptor > path, spp_spptw_res_cont resource);
+	// Returns the rotation made from the given arcs (from the last to the first one)
+	Rotation rotationFromArcs(const vector<int>& arcs, double cost);
 	// Adds a single rotation to the list of solutions
 	void addSingleRotationToListOfSolution();
 
 	// DATA -- COSTS
 	//
 	// Data structures that associates an arc to the chosen short succession of lowest cost
-	map<int,int> shortSuccCDMinIdFromArc_;						// Maps the arcs to the corresponding short rotation ID
+	vector<int> shortSuccCDMinIdFromArc_;						// For each arc, the corresponding short rotation ID (-1 if none)
 	vector3D idBestShortSuccCDMin_;								// For each day k (<= nDays_ - CDMin), shift s, number n, contains the best short succession of size CDMin that starts on day k, and ends with n consecutive days of shift s
 	vector<vector<vector<double> > > arcCostBestShortSuccCDMin_;// For each day k (<= nDays_ - CDMin), shift s, number n, contains the cost of the corresponding arc
 
@@ -717,8 +854,25 @@ protected:
 	void priceShortSucc();
 	// Given a short succession and a start date, returns the cost of the corresponding arc
 	double costArcShortSucc(int size, int id, int startDate);
+
+	// Incremental pricing of the short successions of size CDMin: for each start date d>0 and each
+	// succession id (flat index d*nbSucc+id), the sum over its days of the preference cost minus the
+	// dual cost of the day-shift, and whether none of its day-shifts is forbidden
+	vector<double> windowCostShortSuccCDMin_;
+	vector<char> windowStatusShortSuccCDMin_;
+	// Cost (preference - dual) and status of each day-shift (flat index k*nbShifts+s) at the last pricing
+	vector<double> lastDayShiftCost_;
+	vector<char> lastDayShiftStatus_;
+	// Sums and status of the prefixes of the successions of each size for the start date being evaluated
+	vector< vector<double> > prefixCostShortSucc_;
+	vector< vector<char> > prefixStatusShortSucc_;
+	bool isShortSuccWindowInit_ = false;
+	// Updates the tables above: only the start dates whose days changed since the last pricing are evaluated again
+	void updateShortSuccWindows();
 	// Single cost/time change
-	inline void updateCost(int a, double cost){boost::put( &Arc_Properties::cost, g_, arcsDescriptors_[a], cost );}
+	inline void updateCost(int a, double cost){arcCost_[a] = cost;}
+	// Builds the tables of the arcs whose cost depend on the dual costs. Should only be called ONCE.
+	void initArcCostTables();
 	// Updates the costs depending on the reduced costs given for the nurse
 	void updateArcCosts();
 	// For tests, must be able to randomly generate costs
@@ -740,19 +894,19 @@ protected:
 	vector<bool> arcStatus_;
 	vector<bool> nodeStatus_;
 	vector<bool> startingDayStatus_;
+	// Day-shifts and starting days forbidden in the network, i.e. by the last solve. The next solve only
+	// forbids / authorizes those that differ from its own lists
+	Tools::BitMatrix appliedForbiddenDayShifts_;
+	Tools::BitMatrix appliedForbiddenStartingDays_;
 
 	// FUNCTIONS -- FORBIDDEN ARCS AND NODES
 	//
 	// Returns true if the succession succ starting on day k does not violate any forbidden day-shift
-	bool canSuccStartHere(vector<int> succ, int firstDay);
-	// Forbids some days / shifts
-	void forbid(set<pair<int,int> > forbiddenDayShifts);
-	// Authorizes some days / shifts
-	void authorize(set<pair<int,int> > forbiddenDayShifts);
-	// Forbids some starting days
-	void forbidStartingDays(set<int> forbiddenStartingDays);
-	// Authorizes some starting days
-	void authorizeStartingDays(set<int> forbiddenStartingDays);
+	bool canSuccStartHere(const vector<int>& succ, int firstDay);
+	// Forbids the given days / shifts and authorizes the others
+	void updateForbiddenDayShifts(const Tools::BitMatrix& forbiddenDayShifts);
+	// Forbids the given starting days and authorizes the others
+	void updateForbiddenStartingDays(const Tools::BitMatrix& forbiddenStartingDays);
 	// Know if node / arc is forbidden
 	inline bool isArcForbidden(int a){return ! arcStatus_[a];}
 	inline bool isNodeForbidden(int v){return ! nodeStatus_[v];}
@@ -770,8 +924,8 @@ protected:
 	void authorizeStartingDay(int k);
 	void resetAuthorizations();
 	// Updates the travel time of an arc / node
-	inline void updateTime(int a, int time){     boost::put( &Arc_Properties::time, g_, arcsDescriptors_[a], time );}
-	inline void updateLat(int v, int time){boost::put( &Vertex_Properties::lat, g_, v, time);}
+	inline void updateTime(int a, int time){arcTime_[a] = time;}
+	inline void updateLat(int v, int time){nodeLat_[v] = time;}
 	// Given an arc, returns the normal travel time (i.e. travel time when authorized)
 	int normalTravelTime(int a);
 	// Test for random forbidden day-shift
@@ -847,6 +1001,43 @@ protected:
 	  Visitor vis );
 
 
+	//----------------------------------------------------------------
+	//
+	// Layered label-setting algorithm: the network is acyclic, so the
+	// nodes are processed once in a topological order and the labels
+	// of a node are final when it is reached
+	//
+	//----------------------------------------------------------------
+
+	// DATA -- LAYERED LABEL-SETTING
+	//
+	vector<int> topologicalOrder_;						// All the nodes, every arc goes from a node to a later one
+	vector<layered_label> labelPool_;					// All the labels of the current solve (reused from one solve to the next)
+	vector< vector<int> > labelsByNode_;				// For each node, the indices in labelPool_ of its non-dominated labels
+	vector<double> completionBound_;					// For each node, a lower bound on the cost of the paths from it to a sink
+	vector<int> nodeDay_;								// Day of each node (-1 for the source, nDays_ for the sink)
+	vector<double> originBound_;						// For each node, a lower bound on the cost of the paths from the source to it
+	vector<backward_label> backwardLabelPool_;			// All the backward labels of the current solve
+	vector< vector<int> > backwardLabelsByNode_;		// For each node, the indices in backwardLabelPool_ of its non-dominated labels
+
+	// FUNCTIONS -- LAYERED LABEL-SETTING
+	//
+	// Computes the topological order and the days of the nodes. Should only be called ONCE (when creating the SubProblem).
+	void initTopologicalOrder();
+	void initNodeDays();
+	// Computes the lower bounds on the cost of the paths to the sinks / from the source (no resource)
+	void computeCompletionBounds(const vector<bool>& isSink);
+	void computeOriginBounds();
+	// Extends the labels from the source to the nodes of the days up to lastDay (the sinks are not extended)
+	void extendForwardLabels(const vector<bool>& isSink, int lastDay);
+	// Adds the label (resource, pred, arc) to node v if it is not dominated, and removes the labels it dominates
+	void addLayeredLabel(int v, const spp_spptw_res_cont& res, int pred, int arc);
+	// Same for a backward label
+	void addBackwardLabel(int v, const backward_label& label);
+	// Builds the rotation of the path given by its arcs (from the last to the first) if its cost is below the bound
+	void addRotationFromLabelArcs(const vector<int>& arcs, double cost);
+
+
 
 
 
@@ -866,6 +1057,9 @@ public:
 	inline int nPaths(){return nPaths_;}
 	inline int nLongFound(){return nLongFound_;}
 	inline int nVeryShortFound(){return nVeryShortFound_;}
+	inline double bestReducedCost(){return bestReducedCost_;}
+	inline int nLabelsCreated(){return nLabelsCreated_;}
+	inline int nLabelsDominated(){return nLabelsDominated_;}
 
 	// Print functions.
 	//
@@ -889,6 +1083,21 @@ public:
 	Tools::Timer* timeInS_;
 	Tools::Timer* timeInNL_;
 
+
+	//----------------------------------------------------------------
+	//
+	// Cache of the skeletons (subproblems that were never solved),
+	// identified by the names of the scenario and of the contract,
+	// the number of days and the maximum number of ongoing worked days
+	//
+	//----------------------------------------------------------------
+	// The skeletons are shared, so that a skeleton removed from the cache is deleted only once the threads that are
+	// copying it are done
+	static const unsigned int MAX_NB_SKELETONS = 32;
+	static std::mutex s_skeletonsMutex;
+	static map<string, std::shared_ptr<const SubProblem> > s_skeletons;
+	static std::deque<string> s_skeletonsOrder;			// keys of the skeletons, from the oldest to the newest
+
 };
 
 
@@ -22,7 +22,7 @@ statsRestByNurse_(pScenario->nbNurses()), statsWorkByNurse_(pScenario->nbNurses(
 // of new rotations
 // This method is useful only for the rotation pricer
 //
-void RestTree::addForbiddenShifts(LiveNurse* pNurse, set<pair<int,int> >& forbidenShifts) {
+void RestTree::addForbiddenShifts(LiveNurse* pNurse, Tools::BitMatrix& forbidenShifts) {
 	MyNode* node = currentNode_;
 	vector<MyVar*> arcs;
 	while(node->pParent_){
@@ -34,7 +34,7 @@ void RestTree::addForbiddenShifts(LiveNurse* pNurse, set<pair<int,int> >& forbid
 		{
 			if(restNode->rest_) {
 				for(int i=1; i<pNurse->pScenario_->nbShifts_; ++i)	{
-					forbidenShifts.insert(pair<int,int>(restNode->day_, i));
+					forbidenShifts.set(restNode->day_, i);
 				}
 			}
 		}
@@ -46,7 +46,7 @@ void RestTree::addForbiddenShifts(LiveNurse* pNurse, set<pair<int,int> >& forbid
 		if(shiftNode != 0 && shiftNode->pNurse_ == pNurse)
 		{
 			for(int s: shiftNode->forbiddenShifts_)	{
-				if (s!=0) forbidenShifts.insert(pair<int,int>(shiftNode->day_, s));
+				if (s!=0) forbidenShifts.set(shiftNode->day_, s);
 			}
 		}
 
@@ -64,7 +64,7 @@ void RestTree::addForbiddenShifts(LiveNurse* pNurse, set<pair<int,int> >& forbid
 						if (day<pScenario_->firstDay()) continue;
 						if (day>=pScenario_->firstDay()+pScenario_->nbDays()) continue;
 						for(int i=1; i<pNurse->pScenario_->nbShifts_; ++i)	{
-							forbidenShifts.insert(pair<int,int>(day, i));
+							forbidenShifts.set(day, i);
 						}
 					}
 				}
@@ -333,6 +333,8 @@ bool DiveBranchingRule::branchOnRestingArcs(MyBranchingCandidate& candidate){
 	double advantage = .2;
 	LiveNurse* pBestNurse(0);
 	double lowestScore = DBL_MAX;
+	const bool isStrongBranching = pModel_->getParameters().strongBranchingNbCandidates_ > 0;
+	vector<RestCandidate> candidates;
 
 	for(LiveNurse* pNurse: pMaster_->theLiveNurses_) {
 
@@ -361,6 +363,9 @@ bool DiveBranchingRule::branchOnRestingArcs(MyBranchingCandidate& candidate){
 			currentScore = abs(0.5-frac);
 			if(Tools::isWeekend(k)) currentScore -= advantage;
 
+			if(isStrongBranching)
+				candidates.push_back({pNurse, k, restValue, currentScore});
+
 			if(currentScore < lowestScore){
 				bestDay = k;
 				pBestNurse = pNurse;
@@ -369,6 +374,10 @@ bool DiveBranchingRule::branchOnRestingArcs(MyBranchingCandidate& candidate){
 		}
 	}
 
+	// the heuristic choice is kept if the candidates cannot be evaluated
+	if(isStrongBranching && !candidates.empty())
+		strongBranchingOnRestingArcs(candidates, pBestNurse, bestDay);
+
 	if(pBestNurse != nullptr){
 		//creating the branching cut
 		char name[50];
@@ -393,16 +402,10 @@ bool DiveBranchingRule::branchOnRestingArcs(MyBranchingCandidate& candidate){
 		workNode.setRhs(index, 0);
 
 		// Find the rotation to desactivate
-		for(MyVar* var: pModel_->getActiveColumns()){
-			if(var->getUB() == 0)
-				continue;
-			Rotation rot(var->getPattern());
-			if(rot.nurseId_ != pBestNurse->id_ || rot.firstDay_ > bestDay || rot.firstDay_ + rot.length_ <= bestDay) continue;
-
+		for(MyVar* var: rotationsCoveringDay(pBestNurse, bestDay)){
 			//add the variable to the candidate
 			index = candidate.addBranchingVar(var);
 
-			//check if the shift is present in shifts
 			//set the UB to 0 for the non-possible rotations
 			restNode.setUb(index, 0);
 		}
@@ -425,6 +428,84 @@ bool DiveBranchingRule::branchOnRestingArcs(MyBranchingCandidate& candidate){
 }
 
 
+//-----------------------------------------------------------------------------
+// Choose the resting arcs to branch on among the best candidates
+// The increase of the objective in each child is estimated by its pseudo-costs
+// if they are reliable, otherwise it is evaluated by solving the LP of the
+// children from the current basis. The product of the increases is maximized
+//-----------------------------------------------------------------------------
+
+void DiveBranchingRule::strongBranchingOnRestingArcs(vector<RestCandidate>& candidates, LiveNurse*& pBestNurse, int& bestDay){
+	const SolverParam& param = pModel_->getParameters();
+
+	if(restPseudoCosts_.empty())
+		restPseudoCosts_.assign(pMaster_->theLiveNurses_.size(), vector<RestPseudoCost>(pMaster_->pDemand_->nbDays_));
+
+	// keep the best candidates with respect to the heuristic score
+	stable_sort(candidates.begin(), candidates.end(),
+		[](const RestCandidate& c1, const RestCandidate& c2) { return c1.score_ < c2.score_; });
+	if(candidates.size() > param.strongBranchingNbCandidates_)
+		candidates.resize(param.strongBranchingNbCandidates_);
+
+	double bestScore = -1;
+	LiveNurse* pNurse = pBestNurse;
+	int day = bestDay;
+	for(RestCandidate& c: candidates){
+		RestPseudoCost& pc = restPseudoCosts_[c.pNurse_->id_][c.day_];
+		double restIncrease, workIncrease;
+
+		if(pc.nbEvaluations_ >= param.strongBranchingReliability_){
+			restIncrease = pc.restSum_ / pc.nbEvaluations_ * (1 - c.restValue_);
+			workIncrease = pc.workSum_ / pc.nbEvaluations_ * c.restValue_;
+		}
+		else{
+			// the rest child cannot use the rotations covering the day,
+			// the work child cannot use the resting arcs of the day
+			vector<vector<MyVar*>> children(2);
+			children[0] = rotationsCoveringDay(c.pNurse_, c.day_);
+			children[1] = pMaster_->getRestsPerDay(c.pNurse_)[c.day_];
+			vector<double> objIncreases;
+			if(!pModel_->evaluateChildren(children, objIncreases, param.strongBranchingMaxIterations_))
+				return;
+			restIncrease = objIncreases[0];
+			workIncrease = objIncreases[1];
+
+			if(restIncrease < LARGE_SCORE && workIncrease < LARGE_SCORE){
+				pc.restSum_ += restIncrease / (1 - c.restValue_);
+				pc.workSum_ += workIncrease / c.restValue_;
+				pc.nbEvaluations_ ++;
+			}
+		}
+
+		double score = max(restIncrease, EPSILON) * max(workIncrease, EPSILON);
+		if(score > bestScore){
+			bestScore = score;
+			pNurse = c.pNurse_;
+			day = c.day_;
+		}
+	}
+
+	pBestNurse = pNurse;
+	bestDay = day;
+}
+
+//-----------------------------------------------------------------------------
+// Active rotations of a nurse that cover a day
+//-----------------------------------------------------------------------------
+
+vector<MyVar*> DiveBranchingRule::rotationsCoveringDay(LiveNurse* pNurse, int day){
+	vector<MyVar*> rotations;
+	for(MyVar* var: pModel_->getActiveColumns()){
+		if(var->getUB() == 0)
+			continue;
+		Rotation rot(var->getPattern());
+		if(rot.nurseId_ != pNurse->id_ || rot.firstDay_ > day || rot.firstDay_ + rot.length_ <= day) continue;
+		rotations.push_back(var);
+	}
+	return rotations;
+}
+
+
 //-----------------------------------------------------------------------------
 // Branch on a set of original penalty variables
 //-----------------------------------------------------------------------------
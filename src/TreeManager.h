@@ -108,7 +108,7 @@ struct NursesNumberNode: public MyNode{
 	string write() {
 		stringstream out;
 		out << "NursesNumberNode: (depth=" << depth_ << ",LB=" << bestLB_;
-		out << ",Var=" << pNumberOfNurses_->name_ << ",LB=" << nursesLhs_ << ",UB=" << nursesRhs_ << ")";
+		out << ",Var=" << pNumberOfNurses_->getName() << ",LB=" << nursesLhs_ << ",UB=" << nursesRhs_ << ")";
 		return out.str();
 	}
 
@@ -122,7 +122,7 @@ struct RestTree: public MyTree{
 
 	void logical_fixing();
 
-	void addForbiddenShifts(LiveNurse* pNurse, set<pair<int,int> >& forbidenShifts);
+	void addForbiddenShifts(LiveNurse* pNurse, Tools::BitMatrix& forbidenShifts);
 
 	inline void pushBackNewNursesNumberNode(MyVar* var, double lb, double ub){
 		NursesNumberNode* node = new NursesNumberNode(tree_.size(), currentNode_, var, lb, ub);
@@ -180,6 +180,22 @@ struct ShiftDisjointComparator: public ColumnsComparator{
 	bool is_disjoint(Rotation& rot1, Rotation& rot2) { return rot1.nurseId_!=rot2.nurseId_ && rot1.isShiftDisjointWith(rot2); }
 };
 
+// Candidate (nurse, day) for the branching on the resting arcs
+struct RestCandidate {
+	LiveNurse* pNurse_;
+	int day_;
+	double restValue_; // value of the resting arcs of the nurse on the day
+	double score_; // heuristic score: the lower, the better
+};
+
+// Pseudo-costs of the branching on the resting arcs of a (nurse, day):
+// sums of the increases of the LP objective per unit of change of the value
+// of the resting arcs in the rest and in the work children
+struct RestPseudoCost {
+	double restSum_ = 0, workSum_ = 0;
+	int nbEvaluations_ = 0;
+};
+
 class DiveBranchingRule: public MyBranchingRule
 {
 public:
@@ -192,6 +208,12 @@ public:
    /* branch on a set of resting arcs */
    bool branchOnRestingArcs(MyBranchingCandidate& candidate);
 
+   /* choose the best resting arcs among the candidates with strong branching and pseudo-costs */
+   void strongBranchingOnRestingArcs(vector<RestCandidate>& candidates, LiveNurse*& pBestNurse, int& bestDay);
+
+   /* active rotations of the nurse that cover the day */
+   vector<MyVar*> rotationsCoveringDay(LiveNurse* pNurse, int day);
+
    /* branch on a set of shifts */
    bool branchOnShifts(MyBranchingCandidate& candidate);
 
@@ -221,6 +243,11 @@ protected:
    //pointers to the data
    //
    Modeler* pModel_;
+
+   //pseudo-costs of the branching on the resting arcs of each nurse and day,
+   //kept across the tree
+   //
+   vector<vector<RestPseudoCost>> restPseudoCosts_;
 };
 
 #endif /* SRC_TREEMANAGER_H_ */